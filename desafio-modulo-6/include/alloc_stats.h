@@ -0,0 +1,150 @@
+// alloc_stats.h
+// Contagem de alocações no heap: substitui o operator new/delete global por versões
+// que somam número de alocações e bytes (contadores atômicos, de todas as threads).
+// O FrameProfiler usa isto para mostrar alocações por frame e por fase.
+//
+// Em exatamente um .cpp do executável, antes de qualquer include que traga este:
+//   #define ALLOC_STATS_IMPLEMENTATION
+//   #include "alloc_stats.h"
+// Sem isso os contadores existem, mas ficam em zero (hooked == false).
+//
+// Trechos que não devem alocar (ex.: o envio para a GL no laço) ficam dentro de um
+// NoAllocScope. Com ALLOC_STATS_CHECK (ligado por padrão quando NDEBUG não está
+// definido) toda alocação da mesma thread dentro do trecho conta como violação e é
+// informada no stderr; com ALLOC_STATS_ABORT o programa para ali (bom para o
+// depurador). AllowAllocScope libera de novo um caminho raro e esperado dentro do
+// trecho (crescimento de buffer, primeira entrada de um cache).
+//
+// Não contados: new alinhado (alignas acima de 16) e malloc direto (GL, stb_image).
+//
+// Uso:
+//   alloc_stats::Counters a = alloc_stats::now();
+//   ...
+//   alloc_stats::Counters d = alloc_stats::now() - a;   // d.allocs, d.bytes
+//   { alloc_stats::NoAllocScope guard("envio GL"); ... }
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef ALLOC_STATS_CHECK
+#ifdef NDEBUG
+#define ALLOC_STATS_CHECK 0
+#else
+#define ALLOC_STATS_CHECK 1
+#endif
+#endif
+
+namespace alloc_stats {
+
+struct Counters {
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+};
+
+inline Counters operator-(Counters a, Counters b) {
+    return { a.allocs - b.allocs, a.bytes - b.bytes };
+}
+
+inline std::atomic<uint64_t> allocCount{ 0 };
+inline std::atomic<uint64_t> allocBytes{ 0 };
+inline std::atomic<uint64_t> violationCount{ 0 };
+inline bool                  hooked = false;   // true quando o operator new foi substituído
+
+inline thread_local int         noAllocDepth = 0;
+inline thread_local const char* noAllocName = nullptr;
+
+inline Counters now() {
+    return { allocCount.load(std::memory_order_relaxed), allocBytes.load(std::memory_order_relaxed) };
+}
+
+// Alocações feitas dentro de trechos NoAllocScope (só com ALLOC_STATS_CHECK)
+inline uint64_t violations() { return violationCount.load(std::memory_order_relaxed); }
+
+class NoAllocScope {
+public:
+    explicit NoAllocScope(const char* name) : savedName(noAllocName) {
+        ++noAllocDepth;
+        noAllocName = name;
+    }
+    ~NoAllocScope() { end(); }
+
+    // Encerra o trecho antes do fim do escopo (só conta uma vez)
+    void end() {
+        if (ended) return;
+        ended = true;
+        --noAllocDepth;
+        noAllocName = savedName;
+    }
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+private:
+    const char* savedName;
+    bool        ended = false;
+};
+
+class AllowAllocScope {
+public:
+    AllowAllocScope() : savedDepth(noAllocDepth) { noAllocDepth = 0; }
+    ~AllowAllocScope() { noAllocDepth = savedDepth; }
+    AllowAllocScope(const AllowAllocScope&) = delete;
+    AllowAllocScope& operator=(const AllowAllocScope&) = delete;
+private:
+    int savedDepth;
+};
+
+namespace detail {
+
+// Só fprintf no stderr (sem buffer): nada aqui passa pelo operator new
+inline void violation(std::size_t n) noexcept {
+    uint64_t v = violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (v < 16)
+        std::fprintf(stderr, "[alloc] %zu bytes alocados no trecho sem alocacao \"%s\"\n", n,
+                     noAllocName ? noAllocName : "?");
+    else if (v == 16)
+        std::fprintf(stderr, "[alloc] mais violacoes; so contando\n");
+#ifdef ALLOC_STATS_ABORT
+    std::abort();
+#endif
+}
+
+inline void* allocate(std::size_t n) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(n, std::memory_order_relaxed);
+#if ALLOC_STATS_CHECK
+    if (noAllocDepth > 0) violation(n);
+#endif
+    return std::malloc(n ? n : 1);
+}
+
+} // namespace detail
+} // namespace alloc_stats
+
+#ifdef ALLOC_STATS_IMPLEMENTATION
+#include <new>
+
+namespace alloc_stats { namespace detail {
+static const bool hookInstalled = (hooked = true);
+} }
+
+void* operator new(std::size_t n) {
+    if (void* p = alloc_stats::detail::allocate(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    if (void* p = alloc_stats::detail::allocate(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return alloc_stats::detail::allocate(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return alloc_stats::detail::allocate(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,447 @@
+// bitmap_text.h
+// Texto na janela com fonte bitmap: um atlas de glifos 5x7 (ASCII 32-126, minúsculas
+// desenhadas como maiúsculas) gerado na inicialização, e um lote de quads que sai em
+// um único draw por página de fonte (aqui só há uma página). Retângulos sólidos usam
+// um texel branco do mesmo atlas, então fundos e gráficos entram no mesmo draw.
+//
+// Textos fixos podem ter o layout guardado em cache (cached()): no frame só os
+// vértices prontos são copiados com deslocamento e cor. Textos que mudam (números)
+// são montados na hora, o que custa um laço curto por caractere.
+//
+// PerfOverlay usa o mesmo lote para FPS, gráfico dos tempos de frame, número de
+// draws e alocações do frame anterior.
+//
+// Depois do primeiro uso de cada texto, acumular e desenhar não alocam: o lote e o
+// layout temporário reaproveitam a capacidade, e só a primeira entrada de um texto no
+// cache aloca (liberada de um NoAllocScope).
+//
+// Uso:
+//   TextRenderer text;
+//   text.init(800, 600);                                    // coordenadas em pixels, origem no topo
+//   text.add(text.cached("PONTOS", 2.0f), 10, 10, TextColor::white());
+//   text.text(100, 10, std::to_string(score), 2.0f, TextColor::yellow());
+//   text.flush();                                           // um draw com tudo
+
+#pragma once
+
+#include "alloc_stats.h"
+#include "gl_resources.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TextColor {
+    uint8_t r, g, b, a;
+
+    static TextColor white()  { return { 255, 255, 255, 255 }; }
+    static TextColor yellow() { return { 255, 220, 60, 255 }; }
+    static TextColor red()    { return { 255, 70, 60, 255 }; }
+    static TextColor green()  { return { 90, 230, 110, 255 }; }
+    static TextColor shade()  { return { 0, 0, 0, 150 }; }
+};
+
+struct TextVertex {
+    float   x, y, u, v;
+    uint8_t rgba[4];
+};
+
+// Vértices de uma string já posicionados a partir de (0, 0), em branco
+struct TextLayout {
+    std::vector<TextVertex> verts;
+    float                   width = 0.0f, height = 0.0f;
+};
+
+namespace text_detail {
+
+const int GLYPH_W = 5, GLYPH_H = 7;     // glifo
+const int CELL_W = 6, CELL_H = 8;       // glifo + espaçamento (avanço e altura da linha)
+const int ATLAS_COLS = 16, ATLAS_ROWS = 6;
+const int FIRST = 32, SOLID = 127;      // 127: célula toda branca, para retângulos
+
+struct Glyph {
+    char        c;
+    const char* rows[GLYPH_H];
+};
+
+// '#' aceso, '.' apagado; caracteres fora da tabela ficam em branco
+const Glyph GLYPHS[] = {
+    { '0', { ".###.", "#...#", "#..##", "#.#.#", "##..#", "#...#", ".###." } },
+    { '1', { "..#..", ".##..", "..#..", "..#..", "..#..", "..#..", ".###." } },
+    { '2', { ".###.", "#...#", "....#", "...#.", "..#..", ".#...", "#####" } },
+    { '3', { "#####", "...#.", "..#..", "...#.", "....#", "#...#", ".###." } },
+    { '4', { "...#.", "..##.", ".#.#.", "#..#.", "#####", "...#.", "...#." } },
+    { '5', { "#####", "#....", "####.", "....#", "....#", "#...#", ".###." } },
+    { '6', { "..##.", ".#...", "#....", "####.", "#...#", "#...#", ".###." } },
+    { '7', { "#####", "....#", "...#.", "..#..", ".#...", ".#...", ".#..." } },
+    { '8', { ".###.", "#...#", "#...#", ".###.", "#...#", "#...#", ".###." } },
+    { '9', { ".###.", "#...#", "#...#", ".####", "....#", "...#.", ".##.." } },
+    { 'A', { ".###.", "#...#", "#...#", "#####", "#...#", "#...#", "#...#" } },
+    { 'B', { "####.", "#...#", "#...#", "####.", "#...#", "#...#", "####." } },
+    { 'C', { ".###.", "#...#", "#....", "#....", "#....", "#...#", ".###." } },
+    { 'D', { "###..", "#..#.", "#...#", "#...#", "#...#", "#..#.", "###.." } },
+    { 'E', { "#####", "#....", "#....", "####.", "#....", "#....", "#####" } },
+    { 'F', { "#####", "#....", "#....", "####.", "#....", "#....", "#...." } },
+    { 'G', { ".###.", "#...#", "#....", "#.###", "#...#", "#...#", ".####" } },
+    { 'H', { "#...#", "#...#", "#...#", "#####", "#...#", "#...#", "#...#" } },
+    { 'I', { ".###.", "..#..", "..#..", "..#..", "..#..", "..#..", ".###." } },
+    { 'J', { "..###", "...#.", "...#.", "...#.", "...#.", "#..#.", ".##.." } },
+    { 'K', { "#...#", "#..#.", "#.#..", "##...", "#.#..", "#..#.", "#...#" } },
+    { 'L', { "#....", "#....", "#....", "#....", "#....", "#....", "#####" } },
+    { 'M', { "#...#", "##.##", "#.#.#", "#.#.#", "#...#", "#...#", "#...#" } },
+    { 'N', { "#...#", "#...#", "##..#", "#.#.#", "#..##", "#...#", "#...#" } },
+    { 'O', { ".###.", "#...#", "#...#", "#...#", "#...#", "#...#", ".###." } },
+    { 'P', { "####.", "#...#", "#...#", "####.", "#....", "#....", "#...." } },
+    { 'Q', { ".###.", "#...#", "#...#", "#...#", "#.#.#", "#..#.", ".##.#" } },
+    { 'R', { "####.", "#...#", "#...#", "####.", "#.#..", "#..#.", "#...#" } },
+    { 'S', { ".####", "#....", "#....", ".###.", "....#", "....#", "####." } },
+    { 'T', { "#####", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.." } },
+    { 'U', { "#...#", "#...#", "#...#", "#...#", "#...#", "#...#", ".###." } },
+    { 'V', { "#...#", "#...#", "#...#", "#...#", "#...#", ".#.#.", "..#.." } },
+    { 'W', { "#...#", "#...#", "#...#", "#.#.#", "#.#.#", "#.#.#", ".#.#." } },
+    { 'X', { "#...#", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "#...#" } },
+    { 'Y', { "#...#", "#...#", ".#.#.", "..#..", "..#..", "..#..", "..#.." } },
+    { 'Z', { "#####", "....#", "...#.", "..#..", ".#...", "#....", "#####" } },
+    { '!', { "..#..", "..#..", "..#..", "..#..", "..#..", ".....", "..#.." } },
+    { '"', { ".#.#.", ".#.#.", ".....", ".....", ".....", ".....", "....." } },
+    { '#', { ".#.#.", ".#.#.", "#####", ".#.#.", "#####", ".#.#.", ".#.#." } },
+    { '%', { "##..#", "##..#", "...#.", "..#..", ".#...", "#..##", "#..##" } },
+    { '\'', { "..#..", "..#..", ".....", ".....", ".....", ".....", "....." } },
+    { '(', { "...#.", "..#..", ".#...", ".#...", ".#...", "..#..", "...#." } },
+    { ')', { ".#...", "..#..", "...#.", "...#.", "...#.", "..#..", ".#..." } },
+    { '*', { ".....", "..#..", "#.#.#", ".###.", "#.#.#", "..#..", "....." } },
+    { '+', { ".....", "..#..", "..#..", "#####", "..#..", "..#..", "....." } },
+    { ',', { ".....", ".....", ".....", ".....", ".##..", "..#..", ".#..." } },
+    { '-', { ".....", ".....", ".....", "#####", ".....", ".....", "....." } },
+    { '.', { ".....", ".....", ".....", ".....", ".....", ".##..", ".##.." } },
+    { '/', { ".....", "....#", "...#.", "..#..", ".#...", "#....", "....." } },
+    { ':', { ".....", ".##..", ".##..", ".....", ".##..", ".##..", "....." } },
+    { ';', { ".....", ".##..", ".##..", ".....", ".##..", "..#..", ".#..." } },
+    { '<', { "...#.", "..#..", ".#...", "#....", ".#...", "..#..", "...#." } },
+    { '=', { ".....", ".....", "#####", ".....", "#####", ".....", "....." } },
+    { '>', { ".#...", "..#..", "...#.", "....#", "...#.", "..#..", ".#..." } },
+    { '?', { ".###.", "#...#", "....#", "...#.", "..#..", ".....", "..#.." } },
+    { '[', { ".###.", ".#...", ".#...", ".#...", ".#...", ".#...", ".###." } },
+    { ']', { ".###.", "...#.", "...#.", "...#.", "...#.", "...#.", ".###." } },
+    { '_', { ".....", ".....", ".....", ".....", ".....", ".....", "#####" } },
+    { '|', { "..#..", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.." } },
+};
+
+const char* const VS = R"glsl(
+#version 330 core
+layout(location=0) in vec2 aPos;     // pixels, origem no canto superior esquerdo
+layout(location=1) in vec2 aUV;
+layout(location=2) in vec4 aColor;
+uniform vec2 screenSize;
+out vec2 UV;
+out vec4 Color;
+void main(){
+    UV = aUV;
+    Color = aColor;
+    gl_Position = vec4(aPos.x / screenSize.x * 2.0 - 1.0, 1.0 - aPos.y / screenSize.y * 2.0, 0.0, 1.0);
+}
+)glsl";
+
+const char* const FS = R"glsl(
+#version 330 core
+in vec2 UV;
+in vec4 Color;
+out vec4 Frag;
+uniform sampler2D atlas;
+void main(){
+    float a = texture(atlas, UV).r;
+    if (a < 0.5) discard;
+    Frag = Color;
+}
+)glsl";
+
+inline GLuint compile(GLenum type, const char* src) {
+    GLuint s = glCreateShader(type);
+    glShaderSource(s, 1, &src, nullptr);
+    glCompileShader(s);
+    GLint ok = 0;
+    glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetShaderInfoLog(s, 512, nullptr, log);
+        std::cerr << "Texto: erro no shader:\n" << log;
+    }
+    return s;
+}
+
+} // namespace text_detail
+
+class TextRenderer {
+public:
+    TextRenderer() {
+        batch.reserve(8192);   // HUD e painel cabem sem crescer no meio do frame
+        cacheKey.reserve(128);
+    }
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    void init(int screenW, int screenH) {
+        using namespace text_detail;
+        buildAtlas();
+
+        program = gl::Program::create();
+        GLuint vs = compile(GL_VERTEX_SHADER, VS), fs = compile(GL_FRAGMENT_SHADER, FS);
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        glLinkProgram(program);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "atlas"), 0);
+        locScreen = glGetUniformLocation(program, "screenSize");
+        resize(screenW, screenH);
+
+        vao = gl::VertexArray::create();
+        vbo = gl::Buffer::create();
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, x));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, u));
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (void*)offsetof(TextVertex, rgba));
+        for (GLuint a = 0; a < 3; ++a) glEnableVertexAttribArray(a);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void resize(int screenW, int screenH) {
+        glUseProgram(program);
+        glUniform2f(locScreen, float(screenW), float(screenH));
+    }
+
+    // Layout de uma linha (ou várias, com '\n'); scale = pixels por pixel do glifo
+    TextLayout layout(const std::string& s, float scale) const {
+        TextLayout out;
+        layout(s.c_str(), scale, out);
+        return out;
+    }
+
+    // Mesmo layout, reaproveitando a memória de "out"
+    void layout(const char* s, float scale, TextLayout& out) const {
+        using namespace text_detail;
+        out.verts.clear();
+        out.verts.reserve(std::strlen(s) * 6);
+        out.width = 0.0f;
+        float x = 0.0f, y = 0.0f;
+        for (; *s; ++s) {
+            char ch = *s;
+            if (ch == '\n') {
+                x = 0.0f;
+                y += CELL_H * scale;
+                continue;
+            }
+            int c = (ch >= 'a' && ch <= 'z') ? ch - 'a' + 'A' : (unsigned char)ch;
+            if (c > FIRST && c < SOLID) {
+                int k = c - FIRST;
+                float u0 = float((k % ATLAS_COLS) * CELL_W) / atlasW, v0 = float((k / ATLAS_COLS) * CELL_H) / atlasH;
+                float u1 = u0 + float(GLYPH_W) / atlasW, v1 = v0 + float(GLYPH_H) / atlasH;
+                quad(out.verts, x, y, GLYPH_W * scale, GLYPH_H * scale, u0, v0, u1, v1, TextColor::white());
+            }
+            x += CELL_W * scale;
+            out.width = std::max(out.width, x);
+        }
+        out.height = y + CELL_H * scale;
+    }
+
+    // Layout guardado para textos fixos (a chave inclui a escala). A chave é montada no
+    // cacheKey reservado: com um literal, nenhuma std::string temporária é criada
+    const TextLayout& cached(const char* s, float scale) {
+        char key[32];
+        int n = std::snprintf(key, sizeof(key), "%g|", scale);
+        size_t len = std::strlen(s);
+        if (cacheKey.capacity() < size_t(n) + len) {
+            alloc_stats::AllowAllocScope grow;   // só textos mais longos que os já vistos
+            cacheKey.reserve(size_t(n) + len);
+        }
+        cacheKey.assign(key, size_t(n));
+        cacheKey.append(s, len);
+        auto it = cache.find(cacheKey);
+        if (it == cache.end()) {
+            alloc_stats::AllowAllocScope firstUse;
+            TextLayout l;
+            layout(s, scale, l);
+            it = cache.emplace(cacheKey, std::move(l)).first;
+        }
+        return it->second;
+    }
+
+    const TextLayout& cached(const std::string& s, float scale) { return cached(s.c_str(), scale); }
+
+    void add(const TextLayout& l, float x, float y, TextColor c) {
+        for (TextVertex v : l.verts) {
+            v.x += x;
+            v.y += y;
+            v.rgba[0] = c.r; v.rgba[1] = c.g; v.rgba[2] = c.b; v.rgba[3] = c.a;
+            batch.push_back(v);
+        }
+    }
+
+    // Texto que muda a cada frame; devolve a largura. Com char* (ex.: buffer do
+    // snprintf) nada é alocado, qualquer que seja o tamanho do texto
+    float text(float x, float y, const char* s, float scale, TextColor c) {
+        layout(s, scale, scratch);
+        add(scratch, x, y, c);
+        return scratch.width;
+    }
+    float text(float x, float y, const std::string& s, float scale, TextColor c) {
+        return text(x, y, s.c_str(), scale, c);
+    }
+
+    void rect(float x, float y, float w, float h, TextColor c) {
+        // centro da célula sólida: qualquer ponto do quad amostra branco
+        using namespace text_detail;
+        int k = SOLID - FIRST;
+        float u = (float((k % ATLAS_COLS) * CELL_W) + CELL_W * 0.5f) / atlasW;
+        float v = (float((k / ATLAS_COLS) * CELL_H) + CELL_H * 0.5f) / atlasH;
+        quad(batch, x, y, w, h, u, v, u, v, c);
+    }
+
+    // Desenha tudo que foi acumulado em um draw e esvazia o lote; devolve os draws feitos
+    int flush() {
+        if (batch.empty()) return 0;
+        GLboolean depth = glIsEnabled(GL_DEPTH_TEST), blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glUseProgram(program);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // reespecifica o buffer: o driver não espera o draw anterior
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(batch.size() * sizeof(TextVertex)), batch.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)batch.size());
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (depth) glEnable(GL_DEPTH_TEST);
+        if (!blend) glDisable(GL_BLEND);
+        batch.clear();
+        return 1;
+    }
+
+private:
+    void buildAtlas() {
+        using namespace text_detail;
+        atlasW = ATLAS_COLS * CELL_W;
+        atlasH = ATLAS_ROWS * CELL_H;
+        std::vector<uint8_t> pixels(size_t(atlasW) * atlasH, 0);
+        for (const Glyph& g : GLYPHS) {
+            int k = g.c - FIRST;
+            int x0 = (k % ATLAS_COLS) * CELL_W, y0 = (k / ATLAS_COLS) * CELL_H;
+            for (int r = 0; r < GLYPH_H; ++r)
+                for (int c = 0; c < GLYPH_W; ++c)
+                    if (g.rows[r][c] == '#') pixels[size_t(y0 + r) * atlasW + x0 + c] = 255;
+        }
+        int k = SOLID - FIRST;
+        for (int r = 0; r < CELL_H; ++r)
+            for (int c = 0; c < CELL_W; ++c)
+                pixels[size_t((k / ATLAS_COLS) * CELL_H + r) * atlasW + (k % ATLAS_COLS) * CELL_W + c] = 255;
+
+        // linha 0 da memória = topo dos glifos; os UVs seguem a mesma convenção
+        atlas = gl::Texture::create();
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasW, atlasH, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    static void quad(std::vector<TextVertex>& out, float x, float y, float w, float h,
+                     float u0, float v0, float u1, float v1, TextColor c) {
+        TextVertex a{ x, y, u0, v0, { c.r, c.g, c.b, c.a } };
+        TextVertex b{ x + w, y, u1, v0, { c.r, c.g, c.b, c.a } };
+        TextVertex d{ x + w, y + h, u1, v1, { c.r, c.g, c.b, c.a } };
+        TextVertex e{ x, y + h, u0, v1, { c.r, c.g, c.b, c.a } };
+        out.insert(out.end(), { a, b, d, a, d, e });
+    }
+
+    gl::Program     program;
+    gl::Texture     atlas;
+    gl::VertexArray vao;
+    gl::Buffer      vbo;
+    GLint           locScreen = -1;
+    int             atlasW = 0, atlasH = 0;
+    std::vector<TextVertex>                     batch;
+    TextLayout                                  scratch;
+    std::string                                 cacheKey;
+    std::unordered_map<std::string, TextLayout> cache;
+};
+
+// FPS, tempo de frame (gráfico dos últimos HISTORY frames) e draws, no canto da tela
+class PerfOverlay {
+public:
+    static const int HISTORY = 120;
+
+    void frame(double seconds) {
+        times[head] = float(seconds * 1000.0);
+        head = (head + 1) % HISTORY;
+        count = std::min(count + 1, HISTORY);
+        accum += seconds;
+        ++frames;
+        if (accum >= 0.5) {   // FPS médio a cada meio segundo (o número não pisca)
+            fps = float(frames / accum);
+            accum = 0.0;
+            frames = 0;
+        }
+    }
+
+    // Acrescenta o painel ao lote; drawCalls = draws do frame anterior, texto incluído;
+    // allocs = alocações do frame anterior (negativo: linha omitida)
+    void draw(TextRenderer& text, float x, float y, int drawCalls, long long allocs = -1) {
+        const float scale = 2.0f, graphH = 40.0f, barW = 2.0f;
+        const float w = HISTORY * barW + 8.0f;
+        const float rows = allocs >= 0 ? 18.0f : 0.0f;   // linha extra das alocações
+        text.rect(x, y, w, 70.0f + rows + graphH, TextColor::shade());
+
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.0f", fps);
+        text.add(text.cached("FPS", scale), x + 4, y + 4, TextColor::white());
+        text.text(x + 4 + 4 * 6 * scale, y + 4, buf, scale, TextColor::green());
+
+        float last = times[(head + HISTORY - 1) % HISTORY];
+        std::snprintf(buf, sizeof(buf), "%.2f MS", last);
+        text.add(text.cached("FRAME", scale), x + 4, y + 22, TextColor::white());
+        text.text(x + 4 + 6 * 6 * scale, y + 22, buf, scale, TextColor::green());
+
+        std::snprintf(buf, sizeof(buf), "%d", drawCalls);
+        text.add(text.cached("DRAWS", scale), x + 4, y + 40, TextColor::white());
+        text.text(x + 4 + 6 * 6 * scale, y + 40, buf, scale, TextColor::green());
+
+        if (allocs >= 0) {
+            std::snprintf(buf, sizeof(buf), "%lld", allocs);
+            text.add(text.cached("ALOCS", scale), x + 4, y + 58, TextColor::white());
+            text.text(x + 4 + 6 * 6 * scale, y + 58, buf, scale, allocs ? TextColor::yellow() : TextColor::green());
+        }
+
+        // barras: escala fixa de 0 a 33 ms; a linha marca 16,7 ms (60 Hz)
+        const float gx = x + 4, gy = y + 62 + rows + graphH;
+        text.rect(gx, gy - graphH * (16.7f / 33.3f), HISTORY * barW, 1.0f, TextColor::yellow());
+        for (int i = 0; i < count; ++i) {
+            float ms = times[(head + HISTORY - count + i) % HISTORY];
+            float h = std::min(graphH, graphH * ms / 33.3f);
+            TextColor c = ms > 16.7f ? TextColor::red() : TextColor::green();
+            text.rect(gx + (HISTORY - count + i) * barW, gy - h, barW, h, c);
+        }
+    }
+
+private:
+    float  times[HISTORY] = {};
+    int    head = 0, count = 0;
+    double accum = 0.0;
+    int    frames = 0;
+    float  fps = 0.0f;
+};
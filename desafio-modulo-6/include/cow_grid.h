@@ -0,0 +1,77 @@
+// cow_grid.h
+// Grade 2D com cópia na escrita (copy-on-write) por blocos.
+// As células ficam em blocos de BLOCK×BLOCK, cada um em um shared_ptr. view() copia só
+// os ponteiros (custo proporcional ao número de blocos, não de células) e devolve uma
+// foto imutável que pode ser lida em outra thread; set() clona o bloco antes de
+// escrever se alguma foto ainda o segura, então a foto nunca vê escritas posteriores.
+//
+// Uso:
+//   CowGrid<int> grid(h, w, 0);
+//   grid.set(i, j, 5);
+//   CowGrid<int>::View foto = grid.view();         // thread principal
+//   std::thread([foto] { foto.get(i, j); }).detach();  // leitura em outra thread
+//
+// A grade em si (get/set/view) só deve ser usada por uma thread; as fotos podem ir
+// para qualquer uma.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+template <class T>
+class CowGrid {
+public:
+    static constexpr int BLOCK = 64;
+
+    class View {
+    public:
+        View() = default;
+        int rows() const { return h; }
+        int cols() const { return w; }
+        const T& get(int i, int j) const {
+            return (*blocks[size_t(i / BLOCK) * bw + j / BLOCK])[size_t(i % BLOCK) * BLOCK + j % BLOCK];
+        }
+
+    private:
+        friend class CowGrid;
+        int h = 0, w = 0, bw = 0;
+        std::vector<std::shared_ptr<const std::vector<T>>> blocks;
+    };
+
+    CowGrid(int rows, int cols, const T& fill = T())
+        : h(rows), w(cols), bh((rows + BLOCK - 1) / BLOCK), bw((cols + BLOCK - 1) / BLOCK) {
+        blocks.reserve(size_t(bh) * bw);
+        for (int b = 0; b < bh * bw; ++b)
+            blocks.push_back(std::make_shared<std::vector<T>>(size_t(BLOCK) * BLOCK, fill));
+    }
+
+    int rows() const { return h; }
+    int cols() const { return w; }
+
+    const T& get(int i, int j) const { return (*blocks[blockOf(i, j)])[cellOf(i, j)]; }
+
+    void set(int i, int j, const T& v) {
+        std::shared_ptr<std::vector<T>>& b = blocks[blockOf(i, j)];
+        T& cell = (*b)[cellOf(i, j)];
+        if (cell == v) return;
+        // use_count vê as fotos vivas; um valor antigo só causa uma cópia a mais
+        if (b.use_count() > 1) b = std::make_shared<std::vector<T>>(*b);
+        (*b)[cellOf(i, j)] = v;
+    }
+
+    View view() const {
+        View v;
+        v.h = h;  v.w = w;  v.bw = bw;
+        v.blocks.assign(blocks.begin(), blocks.end());
+        return v;
+    }
+
+private:
+    size_t blockOf(int i, int j) const { return size_t(i / BLOCK) * bw + j / BLOCK; }
+    static size_t cellOf(int i, int j) { return size_t(i % BLOCK) * BLOCK + j % BLOCK; }
+
+    int h, w, bh, bw;
+    std::vector<std::shared_ptr<std::vector<T>>> blocks;
+};
@@ -0,0 +1,181 @@
+// dynamic_resolution.h
+// Resolução dinâmica: a cena é desenhada num alvo fora da tela (render_target_pool.h)
+// numa fração do tamanho da janela e depois ampliada para o framebuffer da janela com
+// glBlitFramebuffer (filtro linear). HUD e painéis vêm depois, direto na janela, em
+// resolução cheia.
+//
+// O tempo de GPU da cena é medido com queries GL_TIME_ELAPSED em rodízio (QUERIES);
+// o resultado é lido alguns frames depois, só quando já está pronto, então medir não
+// trava o laço. A escala anda em passos de 1/LEVELS entre minScale e 1:
+//   - acima do orçamento: desce de uma vez para perto do necessário, supondo custo
+//     proporcional ao número de pixels (escala ao quadrado);
+//   - abaixo de GROW_BELOW do orçamento por GROW_SAMPLES amostras seguidas: sobe um
+//     passo.
+// Amostras medidas numa escala antiga são ignoradas e, depois de cada mudança, espera
+// SETTLE_SAMPLES amostras; assim não oscila. A cópia para a janela não entra na conta.
+//
+// O alvo é pedido com o tamanho cheio da janela e a cena usa só o canto (0,0) do
+// tamanho escalado: mudar a escala não realoca, e redimensionar a janela só troca de
+// alvo quando muda o bucket do pool.
+//
+// Uso:
+//   DynamicResolution res;
+//   res.init(12.0);                              // orçamento da cena em ms
+//   res.setOutput(fbW, fbH);                     // no começo do frame
+//   ... res.width(), res.height() ...            // resolução da cena neste frame
+//   res.beginScene(pool);                        // liga o alvo, viewport e scissor
+//   ... draws da cena ...
+//   res.endScene();                              // mede e amplia; framebuffer 0 ligado
+//   ... HUD ...
+//   res.shutdown(pool);                          // antes do pool.clear()
+
+#pragma once
+
+#include "render_target_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+class DynamicResolution {
+public:
+    static constexpr int    QUERIES = 4;
+    static constexpr int    LEVELS = 20;          // passos de 5%
+    static constexpr int    SETTLE_SAMPLES = 4;
+    static constexpr int    GROW_SAMPLES = 30;
+    static constexpr double GROW_BELOW = 0.7;
+
+    DynamicResolution() = default;
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    void init(double budgetMs, float minScale = 0.5f) {
+        budget = budgetMs;
+        minLevel = std::clamp(int(std::ceil(minScale * LEVELS - 1e-3f)), 1, LEVELS);
+        glGenQueries(QUERIES, queries);
+    }
+
+    // Escala fixa (0..1]; desliga o ajuste automático
+    void setFixed(float scale) {
+        automatic = false;
+        level = std::clamp(int(std::lround(scale * LEVELS)), 1, LEVELS);
+    }
+
+    void setOutput(int fbW, int fbH) {
+        outW = std::max(1, fbW);
+        outH = std::max(1, fbH);
+    }
+
+    void beginScene(RenderTargetPool& pool) {
+        if (target && (target.width != RenderTargetPool::bucketed(outW) ||
+                       target.height != RenderTargetPool::bucketed(outH)))
+            pool.release(target);
+        if (!target) target = pool.acquire(outW, outH, GL_RGBA8, true);
+
+        if (target) {
+            glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+            glViewport(0, 0, width(), height());
+            glScissor(0, 0, width(), height());   // o clear não passa do canto usado
+            glEnable(GL_SCISSOR_TEST);
+        } else {
+            // sem alvo (formato não suportado): desenha direto na janela, sem escala
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, outW, outH);
+        }
+
+        timing = !pending[head];   // GPU mais de QUERIES frames atrás: este frame não mede
+        if (timing) glBeginQuery(GL_TIME_ELAPSED, queries[head]);
+    }
+
+    void endScene() {
+        if (timing) {
+            glEndQuery(GL_TIME_ELAPSED);
+            pending[head] = true;
+            queryLevel[head] = sceneLevel();
+            head = (head + 1) % QUERIES;
+            timing = false;
+        }
+        if (target) {
+            glDisable(GL_SCISSOR_TEST);   // o scissor também corta o blit
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            const bool same = width() == outW && height() == outH;
+            glBlitFramebuffer(0, 0, width(), height(), 0, 0, outW, outH, GL_COLOR_BUFFER_BIT,
+                              same ? GL_NEAREST : GL_LINEAR);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, outW, outH);
+        }
+        collect();
+    }
+
+    void shutdown(RenderTargetPool& pool) {
+        pool.release(target);
+        glDeleteQueries(QUERIES, queries);
+    }
+
+    float  scale() const { return float(sceneLevel()) / LEVELS; }
+    int    width() const { return std::max(1, int(outW * scale() + 0.5f)); }
+    int    height() const { return std::max(1, int(outH * scale() + 0.5f)); }
+    double gpuMs() const { return recentMs; }          // média das últimas medições
+    bool   isAutomatic() const { return automatic; }
+    unsigned long changes() const { return changeCount; }
+
+private:
+    // Sem alvo, a cena sai em resolução cheia
+    int sceneLevel() const { return target ? level : LEVELS; }
+
+    // Lê as queries prontas, da mais antiga para a mais nova, sem esperar a GPU
+    void collect() {
+        while (pending[tail]) {
+            GLint ready = 0;
+            glGetQueryObjectiv(queries[tail], GL_QUERY_RESULT_AVAILABLE, &ready);
+            if (!ready) break;
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[tail], GL_QUERY_RESULT, &ns);
+            pending[tail] = false;
+            sample(double(ns) * 1e-6, queryLevel[tail]);
+            tail = (tail + 1) % QUERIES;
+        }
+    }
+
+    void sample(double ms, int atLevel) {
+        recentMs = recentMs == 0.0 ? ms : recentMs * 0.9 + ms * 0.1;
+        if (!automatic || !target || atLevel != level) return;
+        avgMs = samples == 0 ? ms : avgMs * 0.8 + ms * 0.2;
+        if (++samples < SETTLE_SAMPLES) return;
+
+        if (avgMs > budget) {
+            // custo ~ pixels: a escala que cabe no orçamento (com 10% de folga)
+            double want = scale() * std::sqrt(budget * 0.9 / avgMs);
+            setLevel(std::min(level - 1, int(std::floor(want * LEVELS))));
+        } else if (avgMs < budget * GROW_BELOW) {
+            if (++slack >= GROW_SAMPLES) setLevel(level + 1);
+        } else {
+            slack = 0;
+        }
+    }
+
+    void setLevel(int l) {
+        l = std::clamp(l, minLevel, LEVELS);
+        if (l == level) return;
+        level = l;
+        samples = 0;
+        slack = 0;
+        ++changeCount;
+    }
+
+    RenderTarget  target;
+    GLuint        queries[QUERIES] = {};
+    bool          pending[QUERIES] = {};
+    int           queryLevel[QUERIES] = {};
+    int           head = 0, tail = 0;
+    bool          timing = false;
+
+    double        budget = 12.0;
+    bool          automatic = true;
+    int           level = LEVELS, minLevel = LEVELS / 2;
+    int           outW = 1, outH = 1;
+    double        avgMs = 0.0, recentMs = 0.0;
+    int           samples = 0, slack = 0;
+    unsigned long changeCount = 0;
+};
@@ -0,0 +1,351 @@
+// ecs.h
+// ECS pequeno com armazenamento por arquétipo.
+// Entidades com o mesmo conjunto de componentes ficam no mesmo arquétipo, em blocos
+// (chunks) de 16 KiB; dentro do bloco, cada componente é um vetor contíguo (SoA).
+// Iterar um sistema percorre só os arquétipos que têm os componentes pedidos, bloco a
+// bloco, em ordem de memória.
+//
+// As entidades são handles com geração: ao destruir, o índice volta para uma lista
+// livre e a geração avança, então handles antigos deixam de ser válidos (alive()).
+//
+// Componentes devem ser trivialmente copiáveis (POD); são movidos com memcpy quando a
+// entidade muda de arquétipo (add/remove) ou quando outra ocupa o seu lugar (destroy).
+//
+// Uso:
+//   struct Position { float x, y; };
+//   struct Velocity { float x, y; };
+//   ecs::World world;
+//   ecs::Entity e = world.create(Position{0, 0}, Velocity{1, 0});
+//   world.forEach<Position, Velocity>([](Position& p, Velocity& v) { p.x += v.x; });
+//   world.get<Position>(e).y = 5;
+//   world.destroy(e);
+//
+// Ponteiros/referências para componentes valem até a próxima criação, destruição ou
+// add/remove no mesmo arquétipo. Não crie nem destrua entidades dentro de forEach.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ecs {
+
+struct Entity {
+    uint32_t index      = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+const Entity NULL_ENTITY{};
+
+using Mask = uint64_t;   // até 64 tipos de componente por programa
+const int MAX_COMPONENTS = 64;
+
+namespace detail {
+
+struct ComponentInfo {
+    size_t size;
+    size_t align;
+};
+
+inline std::vector<ComponentInfo>& componentTable() {
+    static std::vector<ComponentInfo> table;
+    return table;
+}
+
+inline int registerComponent(size_t size, size_t align) {
+    auto& t = componentTable();
+    assert(t.size() < (size_t)MAX_COMPONENTS && "tipos de componente demais");
+    t.push_back({ size, align });
+    return (int)t.size() - 1;
+}
+
+} // namespace detail
+
+// Identificador estável do tipo de componente (atribuído no primeiro uso)
+template <class T>
+int componentId() {
+    static_assert(std::is_trivially_copyable<T>::value, "componentes devem ser trivialmente copiaveis");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "alinhamento de componente grande demais");
+    static const int id = detail::registerComponent(sizeof(T), alignof(T));
+    return id;
+}
+
+template <class... Cs>
+Mask maskOf() {
+    Mask m = 0;
+    (void)std::initializer_list<int>{ (m |= Mask(1) << componentId<Cs>(), 0)... };
+    return m;
+}
+
+class World {
+public:
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+    World() = default;
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // Cria uma entidade com os componentes dados
+    template <class... Cs>
+    Entity create(const Cs&... values) {
+        Entity e = allocate();
+        Archetype& a = archetypeFor(maskOf<Cs...>());
+        place(e, a);
+        (void)std::initializer_list<int>{ (write(e, values), 0)... };
+        return e;
+    }
+
+    void destroy(Entity e) {
+        if (!alive(e)) return;
+        removeRow(e.index);
+        Record& r = records[e.index];
+        r.archetype = -1;
+        ++r.generation;
+        freeList.push_back(e.index);
+        --liveCount;
+    }
+
+    bool alive(Entity e) const {
+        return e.index < records.size() && records[e.index].generation == e.generation &&
+               records[e.index].archetype >= 0;
+    }
+
+    template <class C>
+    bool has(Entity e) const {
+        return alive(e) && (archetypes[records[e.index].archetype].mask >> componentId<C>()) & 1;
+    }
+
+    // Referência ao componente (a entidade precisa tê-lo)
+    template <class C>
+    C& get(Entity e) {
+        assert(has<C>(e));
+        const Record& r = records[e.index];
+        Archetype& a = archetypes[r.archetype];
+        return reinterpret_cast<C*>(a.chunks[r.chunk].column(a, componentId<C>()))[r.row];
+    }
+
+    // Acrescenta (ou substitui) um componente; a entidade muda de arquétipo
+    template <class C>
+    void add(Entity e, const C& value) {
+        assert(alive(e));
+        int id = componentId<C>();
+        Mask m = archetypes[records[e.index].archetype].mask;
+        if (!((m >> id) & 1)) migrate(e, m | (Mask(1) << id));
+        write(e, value);
+    }
+
+    template <class C>
+    void remove(Entity e) {
+        if (!has<C>(e)) return;
+        migrate(e, archetypes[records[e.index].archetype].mask & ~(Mask(1) << componentId<C>()));
+    }
+
+    // Chama fn(C&...) para toda entidade que tem os componentes Cs
+    template <class... Cs, class Fn>
+    void forEach(Fn&& fn) {
+        forEachChunk<Cs...>([&](size_t n, Entity*, Cs*... cols) {
+            for (size_t i = 0; i < n; ++i) fn(cols[i]...);
+        });
+    }
+
+    // Igual a forEach, mas também recebe a entidade: fn(Entity, C&...)
+    template <class... Cs, class Fn>
+    void forEachEntity(Fn&& fn) {
+        forEachChunk<Cs...>([&](size_t n, Entity* ents, Cs*... cols) {
+            for (size_t i = 0; i < n; ++i) fn(ents[i], cols[i]...);
+        });
+    }
+
+    // Nível mais baixo: fn(n, Entity*, C*...) uma vez por bloco, com os vetores contíguos
+    template <class... Cs, class Fn>
+    void forEachChunk(Fn&& fn) {
+        Mask m = maskOf<Cs...>();
+        for (Archetype& a : archetypes) {
+            if ((a.mask & m) != m) continue;
+            for (Chunk& c : a.chunks) {
+                if (c.count == 0) continue;
+                fn(c.count, c.entities(), reinterpret_cast<Cs*>(c.column(a, componentId<Cs>()))...);
+            }
+        }
+    }
+
+    template <class... Cs>
+    size_t count() {
+        Mask m = maskOf<Cs...>();
+        size_t n = 0;
+        for (const Archetype& a : archetypes)
+            if ((a.mask & m) == m) n += a.size;
+        return n;
+    }
+
+    size_t size() const { return liveCount; }
+    size_t archetypeCount() const { return archetypes.size(); }
+
+    void clear() {
+        archetypes.clear();
+        bytesPerChunk.clear();
+        archetypeIndex.clear();
+        for (uint32_t i = 0; i < records.size(); ++i) {
+            if (records[i].archetype >= 0) {
+                records[i].archetype = -1;
+                ++records[i].generation;
+                freeList.push_back(i);
+            }
+        }
+        liveCount = 0;
+    }
+
+private:
+    struct Archetype;
+
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> data;
+        size_t count = 0;
+
+        Entity* entities() { return reinterpret_cast<Entity*>(data.get()); }
+        unsigned char* column(const Archetype& a, int id) { return data.get() + a.offset[id]; }
+    };
+
+    struct Archetype {
+        Mask                mask = 0;
+        std::vector<int>    types;                    // ids presentes, em ordem crescente
+        size_t              offset[MAX_COMPONENTS];   // início de cada vetor no bloco
+        size_t              capacity = 0;             // entidades por bloco
+        size_t              size = 0;
+        std::vector<Chunk>  chunks;
+    };
+
+    struct Record {
+        int      archetype = -1;
+        uint32_t chunk = 0, row = 0;
+        uint32_t generation = 0;
+    };
+
+    Entity allocate() {
+        uint32_t idx;
+        if (!freeList.empty()) {
+            idx = freeList.back();
+            freeList.pop_back();
+        } else {
+            idx = (uint32_t)records.size();
+            records.emplace_back();
+        }
+        ++liveCount;
+        return { idx, records[idx].generation };
+    }
+
+    Archetype& archetypeFor(Mask m) {
+        auto it = archetypeIndex.find(m);
+        if (it != archetypeIndex.end()) return archetypes[it->second];
+
+        Archetype a;
+        a.mask = m;
+        size_t rowBytes = sizeof(Entity);
+        for (int id = 0; id < MAX_COMPONENTS; ++id) {
+            if ((m >> id) & 1) {
+                a.types.push_back(id);
+                rowBytes += detail::componentTable()[id].size;
+            }
+        }
+        // reserva folga para o alinhamento de cada vetor
+        size_t slack = a.types.size() * alignof(std::max_align_t);
+        a.capacity = std::max<size_t>(1, (CHUNK_BYTES - slack) / rowBytes);
+
+        size_t off = a.capacity * sizeof(Entity);
+        for (int id : a.types) {
+            const detail::ComponentInfo& ci = detail::componentTable()[id];
+            off = (off + ci.align - 1) / ci.align * ci.align;
+            a.offset[id] = off;
+            off += a.capacity * ci.size;
+        }
+        archetypeIndex[m] = archetypes.size();
+        archetypes.push_back(std::move(a));
+        bytesPerChunk.push_back(std::max(off, CHUNK_BYTES));
+        return archetypes.back();
+    }
+
+    // Reserva a próxima linha livre do arquétipo para "e"
+    void place(Entity e, Archetype& a) {
+        size_t ai = &a - archetypes.data();
+        if (a.chunks.empty() || a.chunks.back().count == a.capacity) {
+            Chunk c;
+            c.data.reset(new unsigned char[bytesPerChunk[ai]]);
+            a.chunks.push_back(std::move(c));
+        }
+        Chunk& c = a.chunks.back();
+        Record& r = records[e.index];
+        r.archetype = (int)ai;
+        r.chunk = (uint32_t)(a.chunks.size() - 1);
+        r.row = (uint32_t)c.count;
+        c.entities()[c.count++] = e;
+        ++a.size;
+    }
+
+    template <class C>
+    void write(Entity e, const C& value) {
+        get<C>(e) = value;
+    }
+
+    // Tira a linha de "index" do arquétipo: a última entidade do arquétipo ocupa o lugar
+    void removeRow(uint32_t index) {
+        Record& r = records[index];
+        Archetype& a = archetypes[r.archetype];
+        Chunk& last = a.chunks.back();
+        uint32_t lastRow = (uint32_t)last.count - 1;
+        Chunk& hole = a.chunks[r.chunk];
+        if (&hole != &last || r.row != lastRow) {
+            for (int id : a.types) {
+                size_t sz = detail::componentTable()[id].size;
+                std::memcpy(hole.column(a, id) + r.row * sz, last.column(a, id) + lastRow * sz, sz);
+            }
+            Entity moved = last.entities()[lastRow];
+            hole.entities()[r.row] = moved;
+            records[moved.index].chunk = r.chunk;
+            records[moved.index].row = r.row;
+        }
+        if (--last.count == 0) a.chunks.pop_back();
+        --a.size;
+    }
+
+    // Move "e" para o arquétipo "m", copiando os componentes em comum
+    void migrate(Entity e, Mask m) {
+        Record old = records[e.index];
+        Archetype& dst = archetypeFor(m);                 // pode realocar "archetypes"
+        Archetype& src = archetypes[old.archetype];
+        size_t dstIndex = archetypeIndex[m];
+        place(e, archetypes[dstIndex]);
+        const Record& now = records[e.index];
+        Chunk& from = src.chunks[old.chunk];
+        Chunk& to = archetypes[dstIndex].chunks[now.chunk];
+        for (int id : src.types) {
+            if (!((dst.mask >> id) & 1)) continue;
+            size_t sz = detail::componentTable()[id].size;
+            std::memcpy(to.column(dst, id) + now.row * sz, from.column(src, id) + old.row * sz, sz);
+        }
+        // tira a linha antiga (removeRow lê o registro, então aponta-o de volta)
+        Record fresh = records[e.index];
+        records[e.index] = old;
+        removeRow(e.index);
+        records[e.index] = fresh;
+    }
+
+    std::vector<Archetype>           archetypes;
+    std::vector<size_t>              bytesPerChunk;
+    std::unordered_map<Mask, size_t> archetypeIndex;
+    std::vector<Record>              records;
+    std::vector<uint32_t>            freeList;
+    size_t                           liveCount = 0;
+};
+
+} // namespace ecs
@@ -0,0 +1,171 @@
+// file_watcher.h
+// Observa arquivos em disco e chama um callback quando eles mudam, em uma thread
+// própria (o callback roda nessa thread: faça nele o trabalho pesado, como
+// reler e comparar o arquivo, e entregue só o resultado para a thread principal).
+//
+// No Linux usa inotify sobre os diretórios dos arquivos (editores costumam salvar
+// escrevendo um arquivo temporário e renomeando, o que trocaria o inode observado).
+// Em outros sistemas faz polling da data de modificação a cada 250 ms.
+// Rajadas de eventos do mesmo arquivo são agrupadas (espera 50 ms sem novidades).
+//
+// Uso:
+//   FileWatcher watcher;
+//   watcher.watch("map.txt", [](const std::string& path) { ... });
+//   watcher.start();          // para sozinho no destrutor
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
+
+class FileWatcher {
+public:
+    using Callback = std::function<void(const std::string& path)>;
+
+    FileWatcher() = default;
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    ~FileWatcher() { stop(); }
+
+    // Registra um arquivo (antes de start)
+    void watch(const std::string& path, Callback cb) {
+        entries.push_back({ path, dirOf(path), nameOf(path), std::move(cb) });
+    }
+
+    // Começa a observar; devolve false se não foi possível (continua sem recarga)
+    bool start() {
+        if (running.load() || entries.empty()) return running.load();
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+        std::set<std::string> dirs;
+        for (const Entry& e : entries) dirs.insert(e.dir);
+        for (const std::string& d : dirs) {
+            int wd = inotify_add_watch(fd, d.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd < 0) {
+                close(fd);
+                fd = -1;
+                return false;
+            }
+            watches.push_back({ wd, d });
+        }
+#endif
+        running = true;
+        thread = std::thread([this] { loop(); });
+        return true;
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        thread.join();
+#ifdef __linux__
+        close(fd);
+        fd = -1;
+        watches.clear();
+#endif
+    }
+
+private:
+    struct Entry {
+        std::string path, dir, name;
+        Callback    cb;
+    };
+
+    static std::string dirOf(const std::string& p) {
+        size_t s = p.find_last_of('/');
+        return s == std::string::npos ? "." : (s == 0 ? "/" : p.substr(0, s));
+    }
+    static std::string nameOf(const std::string& p) {
+        size_t s = p.find_last_of('/');
+        return s == std::string::npos ? p : p.substr(s + 1);
+    }
+
+    void fire(const std::set<size_t>& changed) {
+        for (size_t i : changed) entries[i].cb(entries[i].path);
+    }
+
+#ifdef __linux__
+    // Lê os eventos pendentes e marca os arquivos registrados que mudaram
+    void drain(std::set<size_t>& changed) {
+        alignas(inotify_event) char buf[4096];
+        for (;;) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) return;
+            for (char* p = buf; p < buf + n;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                p += sizeof(inotify_event) + ev->len;
+                if (ev->len == 0) continue;
+                const std::string* dir = nullptr;
+                for (const auto& w : watches)
+                    if (w.first == ev->wd) dir = &w.second;
+                if (!dir) continue;
+                for (size_t i = 0; i < entries.size(); ++i)
+                    if (entries[i].dir == *dir && entries[i].name == ev->name) changed.insert(i);
+            }
+        }
+    }
+
+    void loop() {
+        std::set<size_t> changed;
+        pollfd pfd{ fd, POLLIN, 0 };
+        while (running.load()) {
+            // com algo pendente, espera pouco: se nada mais chegar, dispara
+            int timeout = changed.empty() ? 100 : 50;
+            int r = poll(&pfd, 1, timeout);
+            if (r > 0) {
+                drain(changed);
+            } else if (r == 0 && !changed.empty()) {
+                fire(changed);
+                changed.clear();
+            }
+        }
+    }
+#else
+    void loop() {
+        namespace fs = std::filesystem;
+        std::vector<fs::file_time_type> stamps(entries.size());
+        auto stampOf = [](const std::string& p) {
+            std::error_code ec;
+            auto t = fs::last_write_time(p, ec);
+            return ec ? fs::file_time_type{} : t;
+        };
+        for (size_t i = 0; i < entries.size(); ++i) stamps[i] = stampOf(entries[i].path);
+        while (running.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            std::set<size_t> changed;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                auto t = stampOf(entries[i].path);
+                if (t != stamps[i]) {
+                    stamps[i] = t;
+                    changed.insert(i);
+                }
+            }
+            if (changed.empty()) continue;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            fire(changed);
+        }
+    }
+#endif
+
+    std::vector<Entry> entries;
+    std::atomic<bool>  running{ false };
+    std::thread        thread;
+#ifdef __linux__
+    int fd = -1;
+    std::vector<std::pair<int, std::string>> watches;   // wd -> diretório
+#endif
+};
@@ -0,0 +1,151 @@
+// fov.h
+// Campo de visão por shadowcasting recursivo (8 octantes) e estado de névoa de guerra.
+// O custo de computeFov é proporcional à área do raio, não ao tamanho do mapa.
+//
+// FogOfWar guarda um byte por célula, já no formato de textura de um canal:
+// 0 = nunca visto, EXPLORED = visto antes, VISIBLE = visível agora. A cada update só
+// as células que entraram ou saíram da visão mudam, e cada linha alterada guarda o
+// trecho de colunas sujo; flushRows entrega esses trechos para envio parcial.
+//
+// Uso:
+//   FogOfWar fog(w, h);
+//   fog.update(px, py, 6, [&](int x, int y) { return paredes[y][x]; });
+//   fog.flushRows([&](int y, int x0, int n) { glTexSubImage2D(..., x0, y, n, 1, ..., fog.row(y) + x0); });
+
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fov_detail {
+
+// Octante genérico: (dx, dy) locais viram (x, y) do mapa pela matriz xx, xy, yx, yy
+template <class IsOpaque, class Reveal>
+void castLight(int cx, int cy, int row, float start, float end, int radius,
+               int xx, int xy, int yx, int yy, int w, int h, IsOpaque& opaque, Reveal& reveal) {
+    if (start < end) return;
+    float newStart = 0.0f;
+    for (int i = row; i <= radius; ++i) {
+        bool blocked = false;
+        for (int dx = -i, dy = -i; dx <= 0; ++dx) {
+            float lSlope = (dx - 0.5f) / (dy + 0.5f);
+            float rSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rSlope) continue;
+            if (end > lSlope) break;
+
+            int x = cx + dx * xx + dy * xy;
+            int y = cy + dx * yx + dy * yy;
+            bool inside = x >= 0 && x < w && y >= 0 && y < h;
+            bool wall = !inside || opaque(x, y);   // fora do mapa bloqueia
+            if (inside && dx * dx + dy * dy <= radius * radius) reveal(x, y);
+
+            if (blocked) {
+                if (wall) {
+                    newStart = rSlope;
+                } else {
+                    blocked = false;
+                    start = newStart;
+                }
+            } else if (wall && i < radius) {
+                blocked = true;
+                castLight(cx, cy, i + 1, start, lSlope, radius, xx, xy, yx, yy, w, h, opaque, reveal);
+                newStart = rSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
+} // namespace fov_detail
+
+// Chama reveal(x, y) para cada célula visível a partir de (ox, oy), inclusive a origem.
+// Paredes visíveis também são reveladas. Células podem ser reveladas mais de uma vez
+// (nas bordas entre octantes).
+template <class IsOpaque, class Reveal>
+void computeFov(int ox, int oy, int radius, int w, int h, IsOpaque opaque, Reveal reveal) {
+    static const int mult[4][8] = {
+        { 1,  0,  0, -1, -1,  0,  0,  1 },
+        { 0,  1, -1,  0,  0, -1,  1,  0 },
+        { 0,  1,  1,  0,  0, -1, -1,  0 },
+        { 1,  0,  0,  1, -1,  0,  0, -1 },
+    };
+    if (ox < 0 || ox >= w || oy < 0 || oy >= h) return;
+    reveal(ox, oy);
+    for (int o = 0; o < 8; ++o)
+        fov_detail::castLight(ox, oy, 1, 1.0f, 0.0f, radius,
+                              mult[0][o], mult[1][o], mult[2][o], mult[3][o], w, h, opaque, reveal);
+}
+
+class FogOfWar {
+public:
+    // Os valores já são o brilho usado pelo shader (textura R8)
+    static constexpr uint8_t UNEXPLORED = 0;
+    static constexpr uint8_t EXPLORED   = 96;
+    static constexpr uint8_t VISIBLE    = 255;
+
+    FogOfWar(int w, int h)
+        : w(w), h(h), state(size_t(w) * h, UNEXPLORED), stamp(size_t(w) * h, 0),
+          spanMin(h, INT_MAX), spanMax(h, -1) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+    bool visible(int x, int y) const { return state[size_t(y) * w + x] == VISIBLE; }
+    bool explored(int x, int y) const { return state[size_t(y) * w + x] != UNEXPLORED; }
+    const uint8_t* row(int y) const { return &state[size_t(y) * w]; }
+    const uint8_t* data() const { return state.data(); }
+
+    // Recalcula a visão; o que saiu dela vira EXPLORED. Toca só nas células do raio
+    // antigo e do novo
+    template <class IsOpaque>
+    void update(int ox, int oy, int radius, IsOpaque opaque) {
+        ++epoch;
+        next.clear();
+        computeFov(ox, oy, radius, w, h, opaque, [&](int x, int y) {
+            size_t c = size_t(y) * w + x;
+            if (stamp[c] == epoch) return;
+            stamp[c] = epoch;
+            next.push_back((uint32_t)c);
+            set(c, VISIBLE);
+        });
+        for (uint32_t c : lit) {
+            if (stamp[c] != epoch) set(c, EXPLORED);
+        }
+        lit.swap(next);
+    }
+
+    // Esquece tudo (mapa novo): todas as linhas ficam sujas
+    void reset() {
+        for (size_t c = 0; c < state.size(); ++c) set(c, UNEXPLORED);
+        lit.clear();
+    }
+
+    // Entrega fn(y, x0, n) para cada trecho alterado desde a última chamada
+    template <class Fn>
+    void flushRows(Fn fn) {
+        for (int y : dirtyRows) {
+            fn(y, spanMin[y], spanMax[y] - spanMin[y] + 1);
+            spanMin[y] = INT_MAX;
+            spanMax[y] = -1;
+        }
+        dirtyRows.clear();
+    }
+
+private:
+    void set(size_t c, uint8_t v) {
+        if (state[c] == v) return;
+        state[c] = v;
+        int y = int(c / w), x = int(c % w);
+        if (spanMax[y] < 0) dirtyRows.push_back(y);
+        if (x < spanMin[y]) spanMin[y] = x;
+        if (x > spanMax[y]) spanMax[y] = x;
+    }
+
+    int w, h;
+    std::vector<uint8_t>  state;
+    std::vector<uint32_t> stamp;          // última época em que a célula foi vista
+    uint32_t              epoch = 0;
+    std::vector<uint32_t> lit, next;      // células visíveis (atual / em montagem)
+    std::vector<int>      spanMin, spanMax, dirtyRows;
+};
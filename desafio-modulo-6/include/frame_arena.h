@@ -0,0 +1,126 @@
+// frame_arena.h
+// Arena linear para dados temporários do frame. Alocar é só alinhar e avançar um
+// ponteiro; nada é liberado um a um, e reset() (no começo de cada frame) devolve tudo
+// de uma vez. Se um frame precisar de mais que a capacidade, um bloco extra vem do
+// heap; no reset seguinte os blocos viram um só, do tamanho total, e os próximos
+// frames não alocam mais.
+//
+// Contêineres temporários usam ArenaAllocator<T> (ArenaVector<T> é o std::vector com
+// ele). Nada que está na arena pode sobreviver ao reset. Não é thread-safe: uma arena
+// por thread que aloca.
+//
+// Uso:
+//   FrameArena arena(64 * 1024);
+//   while (...) {
+//       arena.reset();
+//       ArenaVector<int> v(arena);
+//       v.push_back(1);
+//   }
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 64 * 1024) {
+        blocks.reserve(8);
+        addBlock(std::max<size_t>(capacity, 1024));
+    }
+    ~FrameArena() {
+        for (Block& b : blocks) ::operator delete(b.data);
+    }
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        assert(align <= alignof(std::max_align_t) && (align & (align - 1)) == 0);
+        size_t at = (offset + align - 1) & ~(align - 1);
+        if (at + bytes > blocks.back().size) {
+            spent += blocks.back().size;
+            addBlock(std::max(blocks.back().size * 2, bytes + align));
+            at = 0;
+        }
+        offset = at + bytes;
+        return blocks.back().data + at;
+    }
+
+    // Devolve a alocação mais recente (temporários destruídos em ordem inversa liberam
+    // o espaço); qualquer outra fica até o reset
+    void release(void* p, size_t bytes) {
+        unsigned char* c = static_cast<unsigned char*>(p);
+        if (c + bytes == blocks.back().data + offset) offset = size_t(c - blocks.back().data);
+    }
+
+    void reset() {
+        highWater = std::max(highWater, used());
+        if (blocks.size() > 1) {
+            size_t total = 0;
+            for (Block& b : blocks) {
+                total += b.size;
+                ::operator delete(b.data);
+            }
+            blocks.clear();
+            addBlock(total);
+        }
+        offset = 0;
+        spent = 0;
+    }
+
+    size_t used() const { return spent + offset; }                // bytes no frame atual
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks) total += b.size;
+        return total;
+    }
+    size_t   peak() const { return std::max(highWater, used()); }  // maior uso de um frame
+    uint64_t growths() const { return growCount; }                // blocos extras pedidos ao heap
+
+private:
+    struct Block {
+        unsigned char* data;
+        size_t         size;
+    };
+
+    void addBlock(size_t size) {
+        blocks.push_back({ static_cast<unsigned char*>(::operator new(size)), size });
+        if (blocks.size() > 1) ++growCount;
+        offset = 0;
+    }
+
+    std::vector<Block> blocks;
+    size_t             offset = 0;   // no bloco atual (o último)
+    size_t             spent = 0;    // blocos anteriores, inteiros
+    size_t             highWater = 0;
+    uint64_t           growCount = 0;
+};
+
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(FrameArena& arena) noexcept : arena(&arena) {}   // implícito: ArenaVector<T> v(arena)
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) noexcept { arena->release(p, n * sizeof(T)); }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& o) const noexcept { return arena == o.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& o) const noexcept { return arena != o.arena; }
+
+private:
+    template <class U> friend class ArenaAllocator;
+    FrameArena* arena;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,284 @@
+// frame_capture.h
+// Captura dos frames da janela para arquivos, sem parar o laço esperando a GPU.
+//
+// capture() (depois dos draws, antes do glfwSwapBuffers) pede a leitura do back buffer
+// para um pixel pack buffer (PBO) e marca uma fence; o glReadPixels volta na hora. Há
+// SLOTS PBOs em rodízio: os pixels de um frame só são copiados para a memória quando a
+// fence dele já passou, normalmente um ou dois frames depois. Se todos os PBOs ainda
+// estão ocupados, capture() espera o mais antigo e conta em gpuStalls() (como o
+// FrameUniformRing).
+//
+// A gravação roda numa thread própria: converte RGBA (linhas de baixo para cima, como
+// a GL lê) para RGB de cima para baixo e grava:
+//   Png/Ppm  um arquivo por frame, <destino>/frame_000000.png (image_write.h);
+//   Raw      todos os frames, em sequência, num só arquivo RGB24 (vídeo bruto; o
+//            tamanho não pode mudar no meio).
+// A fila de gravação tem até MAX_QUEUED frames; se o disco não acompanha, capture()
+// espera vaga e conta em diskStalls(): nenhum frame é descartado. Os buffers de pixels
+// voltam para uma lista livre e são reaproveitados.
+//
+// Uso:
+//   FrameCapture cap;
+//   cap.start("captura", FrameCapture::Format::Png);
+//   ... draws ..., cap.capture(fbW, fbH); glfwSwapBuffers(win);
+//   cap.finish();                        // antes do gl::shutdown(): lê o que falta e espera a gravação
+
+#pragma once
+
+#include "gl_resources.h"
+#include "image_write.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameCapture {
+public:
+    enum class Format { Png, Ppm, Raw };
+
+    static constexpr int    SLOTS = 3;
+    static constexpr size_t MAX_QUEUED = 8;
+
+    // "png", "ppm" ou "raw"
+    static bool parseFormat(const char* s, Format& f) {
+        if      (std::strcmp(s, "png") == 0) f = Format::Png;
+        else if (std::strcmp(s, "ppm") == 0) f = Format::Ppm;
+        else if (std::strcmp(s, "raw") == 0) f = Format::Raw;
+        else return false;
+        return true;
+    }
+
+    FrameCapture() = default;
+    ~FrameCapture() { stopWriter(); }   // sem GL aqui: finish() já deve ter sido chamado
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Png/Ppm: destino é um diretório (criado se não existe); Raw: o arquivo do vídeo
+    bool start(const std::string& destination, Format f) {
+        dest = destination;
+        format = f;
+        std::error_code ec;
+        if (f == Format::Raw) {
+            std::filesystem::path parent = std::filesystem::path(dest).parent_path();
+            if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+            raw = std::fopen(dest.c_str(), "wb");
+            if (!raw) {
+                std::fprintf(stderr, "Captura: nao foi possivel criar %s\n", dest.c_str());
+                return false;
+            }
+        } else {
+            std::filesystem::create_directories(dest, ec);
+            if (ec) {
+                std::fprintf(stderr, "Captura: nao foi possivel criar o diretorio %s\n", dest.c_str());
+                return false;
+            }
+        }
+        for (Slot& s : slots) s.pbo = gl::Buffer::create();
+        running = true;
+        writer = std::thread([this] { writerLoop(); });
+        return true;
+    }
+
+    bool active() const { return running; }
+
+    // Lê o framebuffer ligado para leitura (o back buffer da janela) sem esperar a GPU
+    void capture(int w, int h) {
+        if (!running || w <= 0 || h <= 0) return;
+        collect(false);
+        Slot& s = slots[head];
+        if (s.fence) {   // a GPU está SLOTS frames atrás: espera o mais antigo
+            ++gpuStallCount;
+            while (s.fence) collect(true);
+        }
+        const size_t bytes = size_t(w) * size_t(h) * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+        if (s.capacity < bytes) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_READ);
+            s.capacity = bytes;
+        }
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s.width = w;
+        s.height = h;
+        s.index = capturedCount++;
+        head = (head + 1) % SLOTS;
+    }
+
+    // Lê os PBOs pendentes (esperando a GPU), grava o resto e libera os PBOs
+    void finish() {
+        if (!running) return;
+        while (slots[tail].fence) collect(true);
+        stopWriter();
+        for (Slot& s : slots) s.pbo.reset();
+        if (raw) {
+            std::fclose(raw);
+            raw = nullptr;
+        }
+    }
+
+    uint64_t captured() const { return capturedCount; }   // frames pedidos
+    uint64_t written() const {                             // frames já gravados
+        std::lock_guard<std::mutex> lock(mutex);
+        return writtenCount;
+    }
+    uint64_t gpuStalls() const { return gpuStallCount; }
+    uint64_t diskStalls() const { return diskStallCount; }
+    uint64_t errors() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return errorCount;
+    }
+    int      rawWidth() const { return rawW; }   // tamanho do vídeo bruto (depois do 1º frame)
+    int      rawHeight() const { return rawH; }
+
+private:
+    struct Slot {
+        gl::Buffer pbo;
+        size_t     capacity = 0;
+        GLsync     fence = nullptr;
+        int        width = 0, height = 0;
+        uint64_t   index = 0;
+    };
+
+    struct Job {
+        std::vector<uint8_t> rgba;
+        int                  width = 0, height = 0;
+        uint64_t             index = 0;
+    };
+
+    // Copia os slots prontos (em ordem); com wait, espera pelo menos o mais antigo
+    void collect(bool wait) {
+        while (slots[tail].fence) {
+            Slot& s = slots[tail];
+            GLenum r = glClientWaitSync(s.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                        wait ? 1000000000ull : 0);
+            if (r == GL_TIMEOUT_EXPIRED) return;
+            wait = false;
+            glDeleteSync(s.fence);
+            s.fence = nullptr;
+
+            Job job{ takeBuffer(), s.width, s.height, s.index };
+            const size_t bytes = size_t(s.width) * size_t(s.height) * 4;
+            job.rgba.resize(bytes);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+            if (void* p = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_READ_BIT)) {
+                std::memcpy(job.rgba.data(), p, bytes);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            tail = (tail + 1) % SLOTS;
+            enqueue(std::move(job));
+        }
+    }
+
+    std::vector<uint8_t> takeBuffer() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (spare.empty()) return {};
+        std::vector<uint8_t> v = std::move(spare.back());
+        spare.pop_back();
+        return v;
+    }
+
+    void enqueue(Job&& job) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.size() >= MAX_QUEUED) {
+            ++diskStallCount;
+            space.wait(lock, [this] { return queue.size() < MAX_QUEUED; });
+        }
+        queue.push_back(std::move(job));
+        ready.notify_one();
+    }
+
+    void writerLoop() {
+        std::vector<uint8_t> rgb;
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this] { return !queue.empty() || stopping; });
+                if (queue.empty()) return;
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            space.notify_one();
+
+            // RGBA de baixo para cima -> RGB de cima para baixo
+            const int w = job.width, h = job.height;
+            rgb.resize(size_t(w) * size_t(h) * 3);
+            for (int y = 0; y < h; ++y) {
+                const uint8_t* src = &job.rgba[size_t(h - 1 - y) * w * 4];
+                uint8_t*       dst = &rgb[size_t(y) * w * 3];
+                for (int x = 0; x < w; ++x, src += 4, dst += 3) {
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
+            bool ok = write(job, rgb);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++writtenCount;
+            if (!ok) ++errorCount;
+            spare.push_back(std::move(job.rgba));
+        }
+    }
+
+    bool write(const Job& job, const std::vector<uint8_t>& rgb) {
+        if (format == Format::Raw) {
+            if (rawW == 0) {
+                rawW = job.width;
+                rawH = job.height;
+            }
+            if (job.width != rawW || job.height != rawH) {
+                std::fprintf(stderr, "Captura: frame %llu com %dx%d no video de %dx%d; ignorado\n",
+                             (unsigned long long)job.index, job.width, job.height, rawW, rawH);
+                return false;
+            }
+            return std::fwrite(rgb.data(), 1, rgb.size(), raw) == rgb.size();
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06llu.%s", (unsigned long long)job.index,
+                      format == Format::Png ? "png" : "ppm");
+        std::string path = (std::filesystem::path(dest) / name).string();
+        bool ok = format == Format::Png ? image_write::png(path.c_str(), rgb.data(), job.width, job.height)
+                                        : image_write::ppm(path.c_str(), rgb.data(), job.width, job.height);
+        if (!ok) std::fprintf(stderr, "Captura: erro ao gravar %s\n", path.c_str());
+        return ok;
+    }
+
+    void stopWriter() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_one();
+        writer.join();
+        running = false;
+    }
+
+    Slot        slots[SLOTS];
+    int         head = 0, tail = 0;
+    std::string dest;
+    Format      format = Format::Png;
+    FILE*       raw = nullptr;
+    int         rawW = 0, rawH = 0;   // escritos só pela thread de gravação
+    bool        running = false;
+
+    std::thread                       writer;
+    mutable std::mutex                mutex;
+    std::condition_variable           ready, space;
+    std::deque<Job>                   queue;
+    std::vector<std::vector<uint8_t>> spare;
+    bool                              stopping = false;
+    uint64_t                          capturedCount = 0, writtenCount = 0, errorCount = 0;
+    uint64_t                          gpuStallCount = 0, diskStallCount = 0;
+};
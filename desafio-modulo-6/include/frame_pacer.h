@@ -0,0 +1,158 @@
+// frame_pacer.h
+// Ritmo do laço principal: substitui o glfwPollEvents do começo do frame e decide
+// quando desenhar.
+//
+// Modos:
+//   OnDemand   só desenha quando algo pediu (requestRedraw, wakeAt, setContinuous);
+//              entre um frame e outro a thread dorme em glfwWaitEvents. Para jogos
+//              por turnos: parado, o processo quase não usa CPU.
+//   Capped     desenha sem parar, limitado a "fps": dorme até perto da hora e gira
+//              o resto (a margem se ajusta ao atraso medido do sleep do sistema).
+//   VSync      desenha sem parar, no ritmo do monitor (glfwSwapInterval(1)).
+//   Unlimited  o mais rápido possível (para medir).
+// Em todos os modos a janela minimizada não desenha, e sem foco o ritmo cai para
+// UNFOCUSED_FPS.
+//
+// Uso:
+//   FramePacer pacer;
+//   pacer.init(window, FramePacer::Mode::OnDemand);
+//   while (pacer.beginFrame()) {       // processa eventos; false = fechar
+//       ...                            // callbacks chamam pacer.requestRedraw()
+//       if (animando) pacer.wakeAt(glfwGetTime() + 1.0 / 15.0);
+//       glfwSwapBuffers(window);
+//   }
+// Outras threads acordam o laço com wake() (ex.: arquivo recarregado).
+
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+class FramePacer {
+public:
+    enum class Mode { OnDemand, Capped, VSync, Unlimited };
+
+    static constexpr double UNFOCUSED_FPS = 10.0;
+
+    // "ondemand", "cap", "vsync" ou "off"
+    static bool parseMode(const char* s, Mode& mode) {
+        if      (std::strcmp(s, "ondemand") == 0) mode = Mode::OnDemand;
+        else if (std::strcmp(s, "cap") == 0)      mode = Mode::Capped;
+        else if (std::strcmp(s, "vsync") == 0)    mode = Mode::VSync;
+        else if (std::strcmp(s, "off") == 0)      mode = Mode::Unlimited;
+        else return false;
+        return true;
+    }
+
+    static const char* modeName(Mode mode) {
+        switch (mode) {
+        case Mode::OnDemand: return "sob demanda";
+        case Mode::Capped:   return "limitado";
+        case Mode::VSync:    return "vsync";
+        default:             return "sem limite";
+        }
+    }
+
+    // Com o contexto da janela já atual (o swap interval vale para ele)
+    void init(GLFWwindow* window, Mode m, double targetFps = 60.0) {
+        win = window;
+        mode_ = m;
+        fps = std::max(1.0, targetFps);
+        // sob demanda também usa vsync: quando anima, não passa da taxa do monitor
+        glfwSwapInterval(m == Mode::OnDemand || m == Mode::VSync ? 1 : 0);
+        instance() = this;
+        glfwSetWindowRefreshCallback(win, [](GLFWwindow*) { instance()->requestRedraw(); });
+        glfwSetWindowFocusCallback(win, [](GLFWwindow*, int) { instance()->requestRedraw(); });
+        glfwSetWindowIconifyCallback(win, [](GLFWwindow*, int) { instance()->requestRedraw(); });
+        lastFrame = glfwGetTime();
+    }
+
+    // Espera a hora do próximo frame processando eventos; false quando a janela deve fechar
+    bool beginFrame() {
+        for (;;) {
+            if (glfwWindowShouldClose(win)) return false;
+            if (glfwGetWindowAttrib(win, GLFW_ICONIFIED)) {
+                glfwWaitEvents();   // nada aparece: dorme até restaurar
+                continue;
+            }
+            const bool focused = glfwGetWindowAttrib(win, GLFW_FOCUSED) != 0;
+            if (mode_ == Mode::OnDemand) {
+                glfwPollEvents();
+                double now = glfwGetTime();
+                if (!redraw.exchange(false) && !continuous && now < wakeTime) {
+                    if (wakeTime < NEVER) glfwWaitEventsTimeout(wakeTime - now);
+                    else                  glfwWaitEvents();
+                    continue;
+                }
+                wakeTime = NEVER;
+                if (!focused && continuous) pace(1.0 / UNFOCUSED_FPS);
+            } else {
+                if (!focused)                   pace(1.0 / UNFOCUSED_FPS);
+                else if (mode_ == Mode::Capped) pace(1.0 / fps);
+                glfwPollEvents();
+            }
+            lastFrame = glfwGetTime();
+            ++frameCount;
+            return true;
+        }
+    }
+
+    // Algo mudou: desenha mais um frame (thread principal, ex.: nos callbacks)
+    void requestRedraw() { redraw.store(true, std::memory_order_relaxed); }
+
+    // De qualquer thread: pede um frame e tira o laço do glfwWaitEvents
+    void wake() {
+        redraw.store(true, std::memory_order_relaxed);
+        glfwPostEmptyEvent();
+    }
+
+    // Próximo frame no máximo em "time" (glfwGetTime); vale até o próximo frame sair
+    void wakeAt(double time) { wakeTime = std::min(wakeTime, time); }
+
+    // Frames seguidos enquanto ligado (ex.: painel de desempenho na tela)
+    void setContinuous(bool on) { continuous = on; }
+
+    Mode     mode() const { return mode_; }
+    uint64_t frames() const { return frameCount; }
+
+private:
+    static constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+    static FramePacer*& instance() {
+        static FramePacer* current = nullptr;   // uma janela por programa
+        return current;
+    }
+
+    // Espera até lastFrame + period: sleep até perto da hora e giro no final
+    void pace(double period) {
+        double target = lastFrame + period;
+        double now = glfwGetTime();
+        if (target < now) return;   // atrasado: não acumula dívida
+        double sleep = target - now - margin;
+        if (sleep > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(sleep));
+            double late = glfwGetTime() - (now + sleep);   // quanto o sistema passou do pedido
+            sleepError = sleepError * 0.9 + std::max(0.0, late) * 0.1;
+            margin = std::min(0.004, std::max(0.0005, sleepError * 2.0));
+        }
+        while (glfwGetTime() < target) std::this_thread::yield();
+    }
+
+    GLFWwindow*       win = nullptr;
+    Mode              mode_ = Mode::OnDemand;
+    double            fps = 60.0;
+    std::atomic<bool> redraw{ true };   // o primeiro frame sempre sai
+    bool              continuous = false;
+    double            wakeTime = NEVER;
+    double            lastFrame = 0.0;
+    double            margin = 0.002, sleepError = 0.001;
+    uint64_t          frameCount = 0;
+};
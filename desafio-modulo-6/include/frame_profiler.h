@@ -0,0 +1,154 @@
+// frame_profiler.h
+// Profiler de frame simples: tempo de cada fase nomeada (ScopedPhase) e utilização
+// dos núcleos pelo JobSystem (tempo ocupado de cada thread / duração do frame).
+// Acumula vários frames e imprime a média a cada "interval" segundos. Se o executável
+// conta alocações (alloc_stats.h), imprime também alocações por frame e por fase.
+//
+// Uso:
+//   FrameProfiler prof(&jobs);
+//   while (...) {
+//       prof.beginFrame();
+//       { FrameProfiler::ScopedPhase p(prof, "preparo"); ... }
+//       { FrameProfiler::ScopedPhase p(prof, "envio GL"); ... }
+//       prof.endFrame(std::cout);
+//   }
+
+#pragma once
+
+#include "alloc_stats.h"
+#include "job_system.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameProfiler(const JobSystem* jobs = nullptr, double interval = 2.0)
+        : jobs(jobs), interval(interval), windowStart(Clock::now()) {
+        if (jobs) {
+            lastBusy.resize(jobs->threadCount());
+            busySum.resize(jobs->threadCount());
+            for (unsigned i = 0; i < jobs->threadCount(); ++i) lastBusy[i] = jobs->busyNanoseconds(i);
+        }
+    }
+
+    class ScopedPhase {
+    public:
+        ScopedPhase(FrameProfiler& p, const char* name)
+            : prof(p), name(name), t0(Clock::now()), allocs0(alloc_stats::now()) {}
+        ~ScopedPhase() { stop(); }
+
+        // Encerra a fase antes do fim do escopo (só conta uma vez)
+        void stop() {
+            if (stopped) return;
+            stopped = true;
+            prof.addPhase(name, std::chrono::duration<double, std::milli>(Clock::now() - t0).count(),
+                          alloc_stats::now() - allocs0);
+        }
+    private:
+        FrameProfiler& prof;
+        const char*    name;
+        Clock::time_point t0;
+        alloc_stats::Counters allocs0;
+        bool           stopped = false;
+    };
+
+    void beginFrame() {
+        frameStart = Clock::now();
+        frameAllocs0 = alloc_stats::now();
+    }
+
+    void addPhase(const char* name, double ms, alloc_stats::Counters allocs = {}) {
+        for (auto& p : phases) {
+            if (p.name == name) {
+                p.ms += ms;
+                p.allocs += allocs.allocs;
+                return;
+            }
+        }
+        phases.push_back({ name, ms, allocs.allocs });
+    }
+
+    // Fecha o frame; imprime e zera a janela quando passar "interval" segundos
+    void endFrame(std::ostream& os) {
+        auto now = Clock::now();
+        frameSum += std::chrono::duration<double, std::milli>(now - frameStart).count();
+        alloc_stats::Counters allocs = alloc_stats::now() - frameAllocs0;
+        allocSum += allocs.allocs;
+        allocBytesSum += allocs.bytes;
+        ++frames;
+        if (jobs) {
+            for (unsigned i = 0; i < lastBusy.size(); ++i) {
+                uint64_t b = jobs->busyNanoseconds(i);
+                busySum[i] += (b - lastBusy[i]) / 1e6;
+                lastBusy[i] = b;
+            }
+        }
+        double window = std::chrono::duration<double>(now - windowStart).count();
+        if (window < interval) return;
+
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.2f", frameSum / frames);
+        os << "[perfil] " << frames << " frames, " << buf << " ms/frame";
+        if (alloc_stats::hooked) {
+            std::snprintf(buf, sizeof(buf), ", %.1f alocs/frame (%.1f KB)", double(allocSum) / frames,
+                          double(allocBytesSum) / frames / 1024.0);
+            os << buf;
+        }
+        for (auto& p : phases) {
+            std::snprintf(buf, sizeof(buf), "%.2f", p.ms / frames);
+            os << " | " << p.name << " " << buf << " ms";
+            if (alloc_stats::hooked) {
+                std::snprintf(buf, sizeof(buf), " %.1f alocs", double(p.allocs) / frames);
+                os << buf;
+            }
+        }
+        if (jobs) {
+            // utilização = tempo executando tarefas / tempo de parede da janela
+            double wallMs = window * 1000.0, total = 0.0;
+            os << " | nucleos:";
+            for (double b : busySum) {
+                std::snprintf(buf, sizeof(buf), " %.0f%%", 100.0 * b / wallMs);
+                os << buf;
+                total += b;
+            }
+            std::snprintf(buf, sizeof(buf), " (media %.0f%%)", 100.0 * total / (wallMs * busySum.size()));
+            os << buf;
+        }
+        os << "\n";
+
+        frames = 0;
+        frameSum = 0.0;
+        allocSum = allocBytesSum = 0;
+        for (auto& p : phases) {
+            p.ms = 0.0;
+            p.allocs = 0;
+        }
+        for (double& b : busySum) b = 0.0;
+        windowStart = now;
+    }
+
+private:
+    struct Phase {
+        std::string name;
+        double      ms;
+        uint64_t    allocs;
+    };
+
+    const JobSystem*  jobs;
+    double            interval;
+    Clock::time_point windowStart, frameStart;
+    int               frames = 0;
+    double            frameSum = 0.0;
+    std::vector<Phase> phases;
+    alloc_stats::Counters frameAllocs0;
+    uint64_t          allocSum = 0, allocBytesSum = 0;
+    std::vector<uint64_t> lastBusy;
+    std::vector<double>   busySum;
+};
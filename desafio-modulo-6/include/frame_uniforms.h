@@ -0,0 +1,122 @@
+// frame_uniforms.h
+// Bloco uniform (std140) com os dados comuns do frame: view-projection, posição da
+// câmera, tamanho do viewport e tempo. É escrito uma vez por frame e ligado a um
+// binding point; todo programa que declara o bloco "Frame" lê dali, sem
+// glUniformMatrix4fv por programa.
+//
+// O buffer tem FRAMES regiões usadas em rodízio. Cada frame escreve na próxima região
+// (mapeada sem sincronizar) e marca uma fence ao terminar; a região só é reescrita
+// FRAMES frames depois, quando a GPU normalmente já terminou de lê-la. Se ainda não
+// terminou, update() espera a fence e conta em stalls().
+//
+// Bloco no shader (a ordem e os tipos precisam bater com FrameUniforms):
+//   layout(std140) uniform Frame {
+//       mat4  viewProj;
+//       vec2  cameraPos;
+//       vec2  viewport;
+//       float time;
+//       float deltaTime;
+//   };
+//
+// Uso:
+//   FrameUniformRing frame;
+//   frame.init(0);                       // binding point 0
+//   frame.attach(program);               // para cada programa
+//   frame.update(data);                  // no começo do frame, antes dos draws
+//   frame.endFrame();                    // depois dos draws, antes do swap
+//   frame.shutdown();                    // antes do gl::shutdown()
+
+#pragma once
+
+#include "gl_resources.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct FrameUniforms {
+    float viewProj[16];   // coluna a coluna (como glm::value_ptr)
+    float cameraPos[2];
+    float viewport[2];
+    float time;
+    float deltaTime;
+    float pad[2];         // std140: o bloco ocupa múltiplos de 16 bytes
+};
+static_assert(offsetof(FrameUniforms, cameraPos) == 64, "std140: vec2 depois do mat4");
+static_assert(offsetof(FrameUniforms, time) == 80, "std140: float depois dos vec2");
+static_assert(sizeof(FrameUniforms) == 96, "std140: tamanho do bloco");
+
+class FrameUniformRing {
+public:
+    static const int FRAMES = 3;
+
+    FrameUniformRing() = default;
+    FrameUniformRing(const FrameUniformRing&) = delete;
+    FrameUniformRing& operator=(const FrameUniformRing&) = delete;
+
+    void init(GLuint bindingPoint) {
+        binding = bindingPoint;
+        GLint align = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+        stride = (sizeof(FrameUniforms) + size_t(align) - 1) / size_t(align) * size_t(align);
+        buffer = gl::Buffer::create();
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, GLsizeiptr(stride * FRAMES), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // Liga o bloco "Frame" do programa ao binding point (programas sem o bloco são ignorados)
+    void attach(GLuint program, const char* blockName = "Frame") const {
+        GLuint index = glGetUniformBlockIndex(program, blockName);
+        if (index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, binding);
+    }
+
+    void update(const FrameUniforms& data) {
+        slot = (slot + 1) % FRAMES;
+        if (fences[slot]) {
+            if (glClientWaitSync(fences[slot], 0, 0) == GL_TIMEOUT_EXPIRED) {
+                ++stallCount;
+                glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+            }
+            glDeleteSync(fences[slot]);
+            fences[slot] = nullptr;
+        }
+        GLintptr offset = GLintptr(stride * slot);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        void* dst = glMapBufferRange(GL_UNIFORM_BUFFER, offset, sizeof(FrameUniforms),
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            std::memcpy(dst, &data, sizeof(FrameUniforms));
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        } else {
+            glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(FrameUniforms), &data);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, sizeof(FrameUniforms));
+    }
+
+    // Marca o fim dos draws que leem a região atual
+    void endFrame() {
+        if (!fences[slot]) fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // Vezes em que a região da vez ainda estava em uso pela GPU
+    uint64_t stalls() const { return stallCount; }
+
+    // Fences não têm handle RAII: apague-as enquanto o contexto existe
+    void shutdown() {
+        for (GLsync& f : fences) {
+            if (f) glDeleteSync(f);
+            f = nullptr;
+        }
+        buffer.reset();
+    }
+
+private:
+    gl::Buffer buffer;
+    GLuint     binding = 0;
+    size_t     stride = 0;
+    int        slot = FRAMES - 1;
+    GLsync     fences[FRAMES] = {};
+    uint64_t   stallCount = 0;
+};
@@ -0,0 +1,252 @@
+// gl_resources.h
+// Handles RAII (só movíveis) para objetos OpenGL: buffers, vertex arrays, texturas,
+// framebuffers e programas. Ao sair de escopo, o objeto não é apagado na hora: vai para uma lista de
+// pendentes que é processada em um ponto seguro do frame (gl::collectGarbage(), depois
+// do glfwSwapBuffers). Buffers, VAOs, texturas e framebuffers liberados voltam para um pool por tipo e
+// são reaproveitados pelo próximo acquire; o excedente do pool é apagado de fato.
+//
+// Uso:
+//   gl::Buffer vbo = gl::Buffer::create();
+//   glBindBuffer(GL_ARRAY_BUFFER, vbo);      // conversão implícita para GLuint
+//   ...
+//   gl::collectGarbage();                    // uma vez por frame
+//   gl::reportLiveObjects(std::cout);        // contagem de objetos vivos
+//   gl::shutdown();                          // antes do glfwTerminate
+//
+// Tudo roda na thread que possui o contexto GL.
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+enum class Kind { Buffer, VertexArray, Texture, Framebuffer, Program, Count };
+
+inline const char* kindName(Kind k) {
+    switch (k) {
+        case Kind::Buffer:      return "buffers";
+        case Kind::VertexArray: return "vertex arrays";
+        case Kind::Texture:     return "texturas";
+        case Kind::Framebuffer: return "framebuffers";
+        case Kind::Program:     return "programas";
+        default:                return "?";
+    }
+}
+
+class Registry {
+public:
+    // Nunca destruído: handles globais ainda podem chamá-lo na saída do programa
+    static Registry& instance() {
+        static Registry* r = new Registry;
+        return *r;
+    }
+
+    // Objetos excedentes ao pool são apagados no collect
+    static const size_t POOL_LIMIT = 256;
+
+    GLuint acquire(Kind k) {
+        Stats& s = stats[int(k)];
+        GLuint id = 0;
+        auto& pool = pools[int(k)];
+        if (!pool.empty()) {
+            id = pool.back();
+            pool.pop_back();
+            ++s.reused;
+        } else {
+            id = create(k);
+            ++s.created;
+        }
+        ++s.live;
+        s.peak = std::max(s.peak, s.live);
+        return id;
+    }
+
+    // Adia a devolução até o próximo collect()
+    void release(Kind k, GLuint id) {
+        if (!id || dead) return;
+        pending.push_back({ k, id });
+        --stats[int(k)].live;
+    }
+
+    // Ponto seguro do frame: recicla ou apaga tudo que foi liberado
+    void collect() {
+        for (const Pending& p : pending) {
+            auto& pool = pools[int(p.kind)];
+            if (p.kind != Kind::Program && pool.size() < POOL_LIMIT) {
+                reset(p.kind, p.id);
+                pool.push_back(p.id);
+            } else {
+                destroy(p.kind, p.id);
+                ++stats[int(p.kind)].deleted;
+            }
+        }
+        pending.clear();
+    }
+
+    // Apaga tudo; handles destruídos depois disto não fazem nada
+    void shutdown() {
+        collect();
+        for (int k = 0; k < int(Kind::Count); ++k) {
+            for (GLuint id : pools[k]) destroy(Kind(k), id);
+            stats[k].deleted += pools[k].size();
+            pools[k].clear();
+        }
+        dead = true;
+    }
+
+    void report(std::ostream& os) const {
+        os << "Objetos GL (vivos / pico / no pool / criados / reaproveitados / apagados):\n";
+        for (int k = 0; k < int(Kind::Count); ++k) {
+            const Stats& s = stats[k];
+            os << "  " << kindName(Kind(k)) << ": " << s.live << " / " << s.peak << " / "
+               << pools[k].size() << " / " << s.created << " / " << s.reused << " / "
+               << s.deleted << "\n";
+        }
+        if (!pending.empty()) os << "  pendentes de coleta: " << pending.size() << "\n";
+    }
+
+    long live(Kind k) const { return stats[int(k)].live; }
+
+private:
+    struct Pending { Kind kind; GLuint id; };
+    struct Stats {
+        long live = 0, peak = 0;
+        unsigned long created = 0, reused = 0, deleted = 0;
+    };
+
+    static GLuint create(Kind k) {
+        GLuint id = 0;
+        switch (k) {
+            case Kind::Buffer:      glGenBuffers(1, &id);      break;
+            case Kind::VertexArray: glGenVertexArrays(1, &id); break;
+            case Kind::Texture:     glGenTextures(1, &id);     break;
+            case Kind::Framebuffer: glGenFramebuffers(1, &id); break;
+            case Kind::Program:     id = glCreateProgram();     break;
+            default: break;
+        }
+        return id;
+    }
+
+    static void destroy(Kind k, GLuint id) {
+        switch (k) {
+            case Kind::Buffer:      glDeleteBuffers(1, &id);      break;
+            case Kind::VertexArray: glDeleteVertexArrays(1, &id); break;
+            case Kind::Texture:     glDeleteTextures(1, &id);     break;
+            case Kind::Framebuffer: glDeleteFramebuffers(1, &id); break;
+            case Kind::Program:     glDeleteProgram(id);          break;
+            default: break;
+        }
+    }
+
+    // Deixa o objeto reciclado sem memória nem estado antigo
+    static void reset(Kind k, GLuint id) {
+        switch (k) {
+            case Kind::Buffer:
+                // libera o armazenamento; o próximo dono chama glBufferData
+                glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+                glBufferData(GL_COPY_WRITE_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                break;
+            case Kind::VertexArray: {
+                // atributos habilitados apontariam para buffers que podem ter sido apagados
+                GLint maxAttribs = 0;
+                glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs);
+                glBindVertexArray(id);
+                for (GLint a = 0; a < maxAttribs; ++a) {
+                    glDisableVertexAttribArray(a);
+                    glVertexAttribDivisor(a, 0);
+                }
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+                glBindVertexArray(0);
+                break;
+            }
+            case Kind::Texture: {
+                // todos os níveis de mipmap ficam vazios e os parâmetros voltam ao padrão
+                // da GL: o próximo dono não herda mipmaps, filtro nem repetição
+                glBindTexture(GL_TEXTURE_2D, id);
+                GLint w = 0, h = 0;
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+                for (GLint level = 0, size = std::max(w, h); level == 0 || size > 0; ++level, size >>= 1)
+                    glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                break;
+            }
+            case Kind::Framebuffer: {
+                // sem anexos: as texturas antigas podem ter voltado ao pool com outro dono
+                GLint bound = 0;
+                glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id);
+                glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+                glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)bound);
+                break;
+            }
+            default: break;
+        }
+    }
+
+    std::vector<GLuint>  pools[int(Kind::Count)];
+    std::vector<Pending> pending;
+    Stats                stats[int(Kind::Count)];
+    bool                 dead = false;
+};
+
+// Handle dono de um objeto GL de tipo K
+template <Kind K>
+class Handle {
+public:
+    Handle() = default;
+    static Handle create() { return Handle(Registry::instance().acquire(K)); }
+
+    ~Handle() { reset(); }
+
+    Handle(Handle&& o) noexcept : handle(std::exchange(o.handle, 0)) {}
+    Handle& operator=(Handle&& o) noexcept {
+        if (this != &o) {
+            reset();
+            handle = std::exchange(o.handle, 0);
+        }
+        return *this;
+    }
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    GLuint id() const { return handle; }
+    operator GLuint() const { return handle; }
+    explicit operator bool() const { return handle != 0; }
+
+    void reset() {
+        if (handle) Registry::instance().release(K, handle);
+        handle = 0;
+    }
+
+private:
+    explicit Handle(GLuint h) : handle(h) {}
+    GLuint handle = 0;
+};
+
+using Buffer      = Handle<Kind::Buffer>;
+using VertexArray = Handle<Kind::VertexArray>;
+using Texture     = Handle<Kind::Texture>;
+using Framebuffer = Handle<Kind::Framebuffer>;
+using Program     = Handle<Kind::Program>;
+
+inline void collectGarbage()                    { Registry::instance().collect(); }
+inline void reportLiveObjects(std::ostream& os) { Registry::instance().report(os); }
+inline void shutdown()                          { Registry::instance().shutdown(); }
+
+} // namespace gl
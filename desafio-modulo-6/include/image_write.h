@@ -0,0 +1,125 @@
+// image_write.h
+// Gravação de imagens RGB de 8 bits (linhas de cima para baixo) em PPM (P6) e PNG.
+// O PNG sai sem compressão (blocos "stored" do deflate, filtro 0 em todas as linhas):
+// é só cabeçalho, CRC e Adler-32, sem depender de zlib. Os arquivos ficam do tamanho
+// dos pixels, mas qualquer leitor de PNG abre (stb_image inclusive).
+//
+// Uso:
+//   image_write::png("saida.png", rgb, w, h);     // false se não conseguiu gravar
+//   image_write::ppm("saida.ppm", rgb, w, h);
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace image_write {
+
+namespace detail {
+
+struct CrcTable {
+    uint32_t v[256];
+    CrcTable() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            v[n] = c;
+        }
+    }
+};
+
+inline const uint32_t* crcTable() {
+    static const CrcTable table;   // inicialização thread-safe
+    return table.v;
+}
+
+inline uint32_t crc(uint32_t c, const uint8_t* p, size_t n) {
+    const uint32_t* t = crcTable();
+    for (size_t i = 0; i < n; ++i) c = t[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c;
+}
+
+inline void be32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(uint8_t(v >> 24));
+    out.push_back(uint8_t(v >> 16));
+    out.push_back(uint8_t(v >> 8));
+    out.push_back(uint8_t(v));
+}
+
+// Chunk: tamanho, tipo, dados, CRC (de tipo + dados)
+inline void chunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t n) {
+    be32(out, uint32_t(n));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + n);
+    be32(out, crc(0xFFFFFFFFu, &out[start], n + 4) ^ 0xFFFFFFFFu);
+}
+
+} // namespace detail
+
+// PNG inteiro em memória (RGB, 8 bits por canal)
+inline std::vector<uint8_t> encodePng(const uint8_t* rgb, int w, int h) {
+    using namespace detail;
+    const size_t rowBytes = size_t(w) * 3 + 1;   // filtro + pixels
+    const size_t raw = rowBytes * size_t(h);
+
+    // zlib: cabeçalho, blocos stored de até 65535 bytes, Adler-32 dos dados
+    std::vector<uint8_t> z;
+    z.reserve(raw + raw / 65535 * 5 + 16);
+    z.push_back(0x78);
+    z.push_back(0x01);
+    uint32_t a = 1, b = 0;
+    size_t   inBlock = 0, left = raw;
+    for (int y = 0; y < h; ++y) {
+        for (size_t i = 0; i < rowBytes; ++i) {
+            if (inBlock == 0) {
+                size_t len = left < 65535 ? left : 65535;
+                z.push_back(left == len ? 1 : 0);   // BFINAL no último, BTYPE = 00
+                z.push_back(uint8_t(len));
+                z.push_back(uint8_t(len >> 8));
+                z.push_back(uint8_t(~len));
+                z.push_back(uint8_t(~len >> 8));
+                inBlock = len;
+            }
+            uint8_t v = i == 0 ? 0 : rgb[size_t(y) * w * 3 + i - 1];
+            z.push_back(v);
+            a = (a + v) % 65521;
+            b = (b + a) % 65521;
+            --inBlock;
+            --left;
+        }
+    }
+    be32(z, (b << 16) | a);
+
+    std::vector<uint8_t> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.reserve(z.size() + 64);
+    std::vector<uint8_t> ihdr;
+    be32(ihdr, uint32_t(w));
+    be32(ihdr, uint32_t(h));
+    ihdr.insert(ihdr.end(), { 8, 2, 0, 0, 0 });   // 8 bits, RGB, deflate, filtro 0, sem entrelaçamento
+    chunk(out, "IHDR", ihdr.data(), ihdr.size());
+    chunk(out, "IDAT", z.data(), z.size());
+    chunk(out, "IEND", nullptr, 0);
+    return out;
+}
+
+inline bool png(const char* path, const uint8_t* rgb, int w, int h) {
+    std::vector<uint8_t> data = encodePng(rgb, w, h);
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+inline bool ppm(const char* path, const uint8_t* rgb, int w, int h) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+    size_t n = size_t(w) * size_t(h) * 3;
+    bool ok = std::fwrite(rgb, 1, n, f) == n;
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace image_write
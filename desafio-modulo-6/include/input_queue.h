@@ -0,0 +1,109 @@
+// input_queue.h
+// Fila de eventos de teclado com a hora de chegada, e medição da latência até o
+// frame que mostra o efeito.
+//
+// O callback de teclado só enfileira (tecla, ação, hora); o laço do frame esvazia a
+// fila em ordem. Assim um toque mais curto que um frame não se perde, e três toques
+// num mesmo frame viram três ações, mesmo com poucos FPS. A fila tem tamanho fixo
+// (sem alocação); se encher, os eventos novos são descartados e contados.
+//
+// InputLatency: para cada evento que teve efeito no frame, pending(hora do evento);
+// logo depois do glfwSwapBuffers, presented(hora atual) fecha as amostras. A hora do
+// evento é a da entrega pelo glfwPollEvents (a GLFW não informa a hora do sistema
+// operacional), então o valor medido é um limite inferior do input-to-photon: não
+// inclui o tempo até o poll nem a varredura do monitor depois do swap. Guarda as
+// últimas SAMPLES amostras para p50/p99.
+//
+// Uso:
+//   InputQueue input;                      // no callback: input.push(key, action, mods, glfwGetTime())
+//   InputEvent ev;
+//   while (input.pop(ev)) { ...; latency.pending(ev.time); }
+//   glfwSwapBuffers(win);
+//   latency.presented(glfwGetTime());
+//   latency.percentile(0.99);              // em ms
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+struct InputEvent {
+    int    key;
+    int    action;   // GLFW_PRESS, GLFW_RELEASE, GLFW_REPEAT
+    int    mods;
+    double time;     // segundos (glfwGetTime) na entrega do evento
+};
+
+class InputQueue {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    void push(int key, int action, int mods, double time) {
+        if (count == CAPACITY) {
+            ++droppedCount;
+            return;
+        }
+        events[(head + count) % CAPACITY] = { key, action, mods, time };
+        ++count;
+    }
+
+    bool pop(InputEvent& ev) {
+        if (count == 0) return false;
+        ev = events[head];
+        head = (head + 1) % CAPACITY;
+        --count;
+        return true;
+    }
+
+    void     clear() { head = count = 0; }
+    size_t   size() const { return count; }
+    uint64_t dropped() const { return droppedCount; }
+
+private:
+    InputEvent events[CAPACITY] = {};
+    size_t     head = 0, count = 0;
+    uint64_t   droppedCount = 0;
+};
+
+class InputLatency {
+public:
+    static constexpr size_t SAMPLES = 512;
+    static constexpr size_t PENDING = 64;
+
+    // Evento cujo efeito entra no frame atual
+    void pending(double eventTime) {
+        if (pendingCount < PENDING) waiting[pendingCount++] = eventTime;
+    }
+
+    // Chamado logo após o swap que mostra o frame
+    void presented(double now) {
+        for (size_t i = 0; i < pendingCount; ++i) {
+            samples[next] = float((now - waiting[i]) * 1000.0);
+            next = (next + 1) % SAMPLES;
+            stored = std::min(stored + 1, SAMPLES);
+            ++total;
+        }
+        pendingCount = 0;
+    }
+
+    // Percentil q (0..1) das últimas amostras, em ms; 0 se ainda não há amostras
+    float percentile(double q) const {
+        if (stored == 0) return 0.0f;
+        std::copy(samples, samples + stored, scratch);
+        size_t k = std::min(stored - 1, size_t(q * double(stored)));
+        std::nth_element(scratch, scratch + k, scratch + stored);
+        return scratch[k];
+    }
+
+    size_t   count() const { return stored; }   // amostras na janela
+    uint64_t totalSamples() const { return total; }
+
+private:
+    double         waiting[PENDING] = {};
+    size_t         pendingCount = 0;
+    float          samples[SAMPLES] = {};
+    mutable float  scratch[SAMPLES] = {};
+    size_t         next = 0, stored = 0;
+    uint64_t       total = 0;
+};
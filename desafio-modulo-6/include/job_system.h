@@ -0,0 +1,242 @@
+// job_system.h
+// Agendador de tarefas com roubo de trabalho (work stealing).
+// Cada thread tem sua própria fila dupla: a dona empilha e desempilha pelo fim
+// (LIFO, bom para cache), as outras roubam pelo início (FIFO, pegam as tarefas
+// maiores). Tarefas podem criar novas tarefas de dentro de outra tarefa.
+//
+// Além do submit/wait simples, há tarefas com dependências e parallelFor:
+//   auto a = jobs.schedule([&] { ... });
+//   auto b = jobs.parallelFor(0, n, 64, [&](size_t lo, size_t hi) { ... }, { a });
+//   auto c = jobs.schedule([&] { ... }, { a, b });   // roda depois de a e b
+//   jobs.wait(c);                                    // ajuda a executar enquanto espera
+// O tempo ocupado de cada thread fica em busyNanoseconds(i) (ver frame_profiler.h).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Nó do grafo de tarefas: termina quando a própria função e todos os pedaços
+// criados por ela (parallelFor) acabam; aí libera as continuações
+struct TaskNode {
+    std::function<void()>                  fn;
+    std::atomic<int>                       waitingDeps{1};   // +1 enquanto é montado
+    std::atomic<int>                       open{1};          // função + pedaços
+    std::atomic<bool>                      done{false};
+    std::mutex                             m;
+    std::vector<std::shared_ptr<TaskNode>> continuations;
+};
+
+class JobSystem {
+public:
+    using Job  = std::function<void()>;
+    using Task = std::shared_ptr<TaskNode>;
+
+    // nThreads = 0 usa todos os núcleos; a thread que chama wait() também trabalha
+    explicit JobSystem(unsigned nThreads = 0)
+        : queues(nThreads ? nThreads : std::max(1u, std::thread::hardware_concurrency())) {
+        // a última fila pertence à thread de fora (quem chama submit/wait)
+        for (unsigned i = 0; i + 1 < threadCount(); ++i)
+            workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lk(sleepMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned threadCount() const { return (unsigned)queues.size(); }
+
+    // Índice da fila da thread atual (trabalhadoras: 0..n-2, externa: n-1)
+    unsigned currentIndex() const {
+        return (tlsOwner == this) ? tlsIndex : threadCount() - 1;
+    }
+
+    void submit(Job job) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        Queue& q = queues[currentIndex()];
+        {
+            std::lock_guard<std::mutex> lk(q.m);
+            q.jobs.push_back(std::move(job));
+            queued.fetch_add(1, std::memory_order_release);
+        }
+        // a trabalhadora confere "queued" segurando sleepMutex antes de dormir: pegar o
+        // mutex depois do incremento garante que ela viu a tarefa ou já está no wait
+        std::lock_guard<std::mutex> lk(sleepMutex);
+        sleepCv.notify_one();
+    }
+
+    // Executa tarefas junto com as trabalhadoras até não restar nenhuma pendente.
+    // Deve ser chamada pela thread externa, nunca de dentro de uma tarefa.
+    void wait() {
+        unsigned self = currentIndex();
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!runOne(self)) std::this_thread::yield();
+        }
+    }
+
+    // Agenda fn para rodar depois que todas as dependências terminarem
+    Task schedule(Job fn, std::initializer_list<Task> deps = {}) {
+        Task t = prepare(deps);
+        t->fn = std::move(fn);
+        release(t);
+        return t;
+    }
+
+    // fn(lo, hi) sobre [begin, end) em pedaços de até "grain" elementos, distribuídos
+    // entre as threads; a tarefa devolvida termina quando todos os pedaços acabam
+    template <class Fn>
+    Task parallelFor(size_t begin, size_t end, size_t grain, Fn fn, std::initializer_list<Task> deps = {}) {
+        grain = std::max<size_t>(1, grain);
+        Task t = prepare(deps);
+        std::weak_ptr<TaskNode> weak = t;   // a tarefa em execução mantém o nó vivo
+        t->fn = [this, weak, begin, end, grain, fn] {
+            Task self = weak.lock();
+            // o primeiro pedaço roda aqui mesmo; os demais viram tarefas
+            for (size_t lo = begin + grain; lo < end; lo += grain) {
+                size_t hi = std::min(end, lo + grain);
+                self->open.fetch_add(1, std::memory_order_relaxed);
+                submit([this, self, fn, lo, hi] { fn(lo, hi); close(self); });
+            }
+            if (begin < end) fn(begin, std::min(end, begin + grain));
+        };
+        release(t);
+        return t;
+    }
+
+    // Ajuda a executar tarefas até "t" terminar (pode ser chamada de qualquer thread)
+    void wait(const Task& t) {
+        if (!t) return;
+        unsigned self = currentIndex();
+        while (!t->done.load(std::memory_order_acquire)) {
+            if (!runOne(self)) std::this_thread::yield();
+        }
+    }
+
+    // Tempo acumulado executando tarefas pela thread i (0..threadCount()-1)
+    uint64_t busyNanoseconds(unsigned i) const {
+        return queues[i].busyNs.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Queue {
+        std::mutex            m;
+        std::deque<Job>       jobs;
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    // Cria o nó já registrado nas dependências; só roda depois do release()
+    Task prepare(std::initializer_list<Task> deps) {
+        Task t = std::make_shared<TaskNode>();
+        for (const Task& d : deps) {
+            if (!d) continue;
+            std::lock_guard<std::mutex> lk(d->m);
+            if (d->done.load(std::memory_order_relaxed)) continue;
+            t->waitingDeps.fetch_add(1, std::memory_order_relaxed);
+            d->continuations.push_back(t);
+        }
+        return t;
+    }
+
+    void release(const Task& t) {
+        if (t->waitingDeps.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        submit([this, t] {
+            t->fn();
+            t->fn = nullptr;
+            close(t);
+        });
+    }
+
+    void close(const Task& t) {
+        if (t->open.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        std::vector<Task> next;
+        {
+            std::lock_guard<std::mutex> lk(t->m);
+            t->done.store(true, std::memory_order_release);
+            next.swap(t->continuations);
+        }
+        for (const Task& n : next) release(n);
+    }
+
+    bool popLocal(unsigned self, Job& out) {
+        Queue& q = queues[self];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.jobs.empty()) return false;
+        out = std::move(q.jobs.back());
+        q.jobs.pop_back();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool steal(unsigned self, Job& out) {
+        unsigned n = threadCount();
+        for (unsigned k = 1; k < n; ++k) {
+            Queue& q = queues[(self + k) % n];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (q.jobs.empty()) continue;
+            out = std::move(q.jobs.front());
+            q.jobs.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool runOne(unsigned self) {
+        Job job;
+        if (!popLocal(self, job) && !steal(self, job)) return false;
+        // só a tarefa mais externa conta tempo (wait() dentro de tarefa também roda outras)
+        if (tlsDepth++ == 0) {
+            auto t0 = std::chrono::steady_clock::now();
+            job();
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+            queues[self].busyNs.fetch_add((uint64_t)ns, std::memory_order_relaxed);
+        } else {
+            job();
+        }
+        --tlsDepth;
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    void workerLoop(unsigned index) {
+        tlsOwner = this;
+        tlsIndex = index;
+        for (;;) {
+            if (runOne(index)) continue;
+            // dorme até haver tarefa em alguma fila (submit() avisa) ou o destrutor
+            std::unique_lock<std::mutex> lk(sleepMutex);
+            sleepCv.wait(lk, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping) return;
+        }
+    }
+
+    std::vector<Queue>       queues;
+    std::vector<std::thread> workers;
+    std::atomic<int>         pending{0};   // submetidas e ainda não terminadas
+    std::atomic<int>         queued{0};    // nas filas, esperando quem as execute
+    std::mutex               sleepMutex;
+    std::condition_variable  sleepCv;
+    bool                     stopping = false;
+
+    static inline thread_local const JobSystem* tlsOwner = nullptr;
+    static inline thread_local unsigned         tlsIndex = 0;
+    static inline thread_local unsigned         tlsDepth = 0;
+};
@@ -0,0 +1,315 @@
+// logger.h
+// Log assíncrono para caminhos quentes. Cada thread formata a mensagem (snprintf, sem
+// alocação) direto em um anel próprio de registros de tamanho fixo, sem trava: só ela
+// escreve no anel e só a thread do logger lê. Se o anel estiver cheio a mensagem é
+// descartada (e contada), nunca espera. A thread do logger acorda a cada poucos ms,
+// junta os anéis em ordem de tempo e grava em lote (avisos e erros em stderr, o resto
+// em stdout).
+//
+// Repetições: cada ponto de log (LOG_* em uma linha do código) aceita no máximo
+// LOG_RATE_LIMIT mensagens por segundo; as excedentes são só contadas, e a próxima que
+// passa informa quantas foram suprimidas. Mensagens idênticas em sequência saem uma
+// vez, seguidas de "(repetida N vezes)".
+//
+// Níveis abaixo de LOG_LEVEL somem na compilação (defina antes de incluir, ou com
+// -DLOG_LEVEL=...): LOG_LEVEL_DEBUG, LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_ERROR.
+//
+// Uso:
+//   LOG_INFO("Item coletado! Tipo: %d", type);
+//   LOG_WARN("Tile ID %d nao encontrado", id);
+//   Logger::instance().flush();     // espera esvaziar (ex.: antes de sair)
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_RATE_LIMIT
+#define LOG_RATE_LIMIT 20   // mensagens por segundo por ponto de log
+#endif
+
+// Estado de um ponto de log (um por LOG_* no código), para o limite de taxa
+struct LogSite {
+    std::atomic<int64_t>  windowStart{ 0 };   // ns
+    std::atomic<uint32_t> inWindow{ 0 };
+    std::atomic<uint32_t> suppressed{ 0 };
+};
+
+class Logger {
+public:
+    static const size_t RING_SIZE = 256;    // registros por thread
+    static const size_t TEXT_SIZE = 224;    // bytes de texto por registro (o resto é cortado)
+
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lk(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        writer.join();
+    }
+
+#if defined(__GNUC__)
+    __attribute__((format(printf, 4, 5)))
+#endif
+    void write(int level, LogSite& site, const char* fmt, ...) {
+        int64_t now = nowNs();
+        if (!admit(site, now)) return;
+
+        Ring& ring = localRing();
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Record& r = ring.slots[head % RING_SIZE];
+        r.time = now;
+        r.level = level;
+        r.site = &site;
+        r.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+        va_list args;
+        va_start(args, fmt);
+        int n = std::vsnprintf(r.text, TEXT_SIZE, fmt, args);
+        va_end(args);
+        r.len = (uint16_t)std::max(0, std::min(n, int(TEXT_SIZE) - 1));
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    // Bloqueia até tudo que já foi registrado estar gravado (fora do laço do frame)
+    void flush() {
+        std::unique_lock<std::mutex> lk(wakeMutex);
+        uint64_t target = ++flushRequests;
+        wake.notify_all();
+        flushed.wait(lk, [&] { return flushesDone >= target || stopping; });
+    }
+
+    // Mensagens descartadas por anel cheio
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        int64_t        time;
+        int            level;
+        const LogSite* site;
+        uint32_t       suppressed;
+        uint16_t       len;
+        char           text[TEXT_SIZE];
+    };
+
+    struct Ring {
+        std::atomic<uint64_t> head{ 0 };   // escrito só pela thread dona
+        std::atomic<uint64_t> tail{ 0 };   // escrito só pela thread do logger
+        std::atomic<bool>     owned{ true };
+        Record                slots[RING_SIZE];
+    };
+
+    // Devolve o anel quando a thread termina; a próxima thread nova pode reaproveitá-lo
+    struct RingLease {
+        Ring* ring = nullptr;
+        ~RingLease() {
+            if (ring) ring->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    Logger() : writer([this] { loop(); }) {}
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static bool admit(LogSite& site, int64_t now) {
+        int64_t start = site.windowStart.load(std::memory_order_relaxed);
+        if (now - start >= 1000000000) {
+            if (site.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+                site.inWindow.store(0, std::memory_order_relaxed);
+        }
+        if (site.inWindow.fetch_add(1, std::memory_order_relaxed) < LOG_RATE_LIMIT) return true;
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Só a primeira mensagem de cada thread passa pela trava (para registrar o anel)
+    Ring& localRing() {
+        thread_local RingLease lease;
+        if (lease.ring) return *lease.ring;
+        std::lock_guard<std::mutex> lk(ringsMutex);
+        for (auto& r : rings) {
+            if (!r->owned.load(std::memory_order_acquire) &&
+                r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_acquire)) {
+                r->owned.store(true, std::memory_order_relaxed);
+                lease.ring = r.get();
+                return *lease.ring;
+            }
+        }
+        rings.emplace_back(new Ring);
+        lease.ring = rings.back().get();
+        return *lease.ring;
+    }
+
+    // Lê tudo que está pronto em todos os anéis e grava em ordem de tempo
+    void drain() {
+        std::vector<Ring*> snapshot;
+        {
+            std::lock_guard<std::mutex> lk(ringsMutex);
+            for (auto& r : rings) snapshot.push_back(r.get());
+        }
+        batch.clear();
+        std::vector<std::pair<Ring*, uint64_t>> ends;
+        for (Ring* r : snapshot) {
+            uint64_t tail = r->tail.load(std::memory_order_relaxed);
+            uint64_t head = r->head.load(std::memory_order_acquire);
+            for (uint64_t i = tail; i < head; ++i) batch.push_back(&r->slots[i % RING_SIZE]);
+            ends.push_back({ r, head });
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const Record* a, const Record* b) { return a->time < b->time; });
+
+        out.clear();
+        err.clear();
+        for (const Record* r : batch) {
+            if (lastSite == r->site && r->suppressed == 0 && lastText.compare(0, std::string::npos, r->text, r->len) == 0) {
+                ++repeats;
+                continue;
+            }
+            endRun();
+            std::string& dst = r->level >= LOG_LEVEL_WARN ? err : out;
+            dst.append(r->text, r->len);
+            if (r->suppressed) dst += " [+" + std::to_string(r->suppressed) + " suprimidas]";
+            dst += '\n';
+            lastSite = r->site;
+            lastText.assign(r->text, r->len);
+            lastLevel = r->level;
+        }
+        // registros lidos: libera os espaços para as threads produtoras
+        for (auto& e : ends) e.first->tail.store(e.second, std::memory_order_release);
+        if (batch.empty()) endRun();   // rajada terminou: informa as repetições
+
+        uint64_t d = dropped.load(std::memory_order_relaxed);
+        if (d != reportedDropped) {
+            err += "[log] " + std::to_string(d - reportedDropped) + " mensagens descartadas (anel cheio)\n";
+            reportedDropped = d;
+        }
+        emit();
+    }
+
+    void emit() {
+        if (!out.empty()) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fflush(stdout);
+        }
+        if (!err.empty()) {
+            std::fwrite(err.data(), 1, err.size(), stderr);
+            std::fflush(stderr);
+        }
+        out.clear();
+        err.clear();
+    }
+
+    void endRun() {
+        if (repeats == 0) return;
+        std::string& dst = lastLevel >= LOG_LEVEL_WARN ? err : out;
+        dst += "  (repetida " + std::to_string(repeats) + " vezes)\n";
+        repeats = 0;
+        lastSite = nullptr;
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lk(wakeMutex);
+        for (;;) {
+            wake.wait_for(lk, std::chrono::milliseconds(5), [&] { return stopping || flushRequests > flushesDone; });
+            bool stop = stopping;
+            uint64_t target = flushRequests;
+            lk.unlock();
+            drain();
+            lk.lock();
+            if (target > flushesDone) {
+                flushesDone = target;
+                flushed.notify_all();
+            }
+            if (stop) {
+                lk.unlock();
+                drain();   // o que chegou durante o último drain
+                endRun();
+                emit();
+                return;
+            }
+        }
+    }
+
+    std::mutex                         ringsMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::atomic<uint64_t>              dropped{ 0 };
+
+    std::mutex              wakeMutex;
+    std::condition_variable wake, flushed;
+    bool                    stopping = false;
+    uint64_t                flushRequests = 0, flushesDone = 0;
+
+    // só a thread do logger mexe nestes
+    std::vector<const Record*> batch;
+    std::string                out, err, lastText;
+    const LogSite*             lastSite = nullptr;
+    int                        lastLevel = 0;
+    uint64_t                   repeats = 0, reportedDropped = 0;
+
+    std::thread writer;   // por último: começa com o resto já construído
+};
+
+#define LOG_AT_(level, ...)                                                  \
+    do {                                                                     \
+        static LogSite logSite_;                                             \
+        Logger::instance().write(level, logSite_, __VA_ARGS__);              \
+    } while (0)
+
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_AT_(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_AT_(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_AT_(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_AT_(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
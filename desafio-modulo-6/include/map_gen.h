@@ -0,0 +1,327 @@
+// map_gen.h
+// Gerador procedural de mapas para o IsometricTilemap (tiles 0-5, alturas e itens).
+// O terreno vem de ruído de valor em oitavas (fbm): a elevação escolhe o bioma por
+// limiares e a umidade separa grama de campo. Cada célula é função pura de (semente,
+// x, y), então o mapa é gerado em paralelo por faixas de CHUNK_ROWS linhas e sai
+// idêntico com qualquer número de threads. Os itens só vão para células que o jogador
+// alcança a partir da clareira (busca em largura com as regras de movimento do jogo);
+// os de cada faixa são juntados na ordem das faixas, e todo mapa tem pelo menos um.
+//
+// Biomas (ver tile_properties.txt):
+//   3 água (game over) | 2 areia | 1 grama / 0 campo | 4 colina | 5 montanha (bloqueia)
+// O centro do mapa (início do jogador) vira uma clareira 3x3 de campo.
+//
+// Uso:
+//   JobSystem jobs;
+//   GeneratedMap map;
+//   generateMap({ 1024, 1024, 42 }, jobs, map);
+//   writeMapText(map, "map.txt", jobs);
+//   writeItemsText(map, "items.txt");
+//   writeMapBinary(map, "map.bin");
+
+#pragma once
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct MapGenParams {
+    int      width = 15, height = 15;
+    uint64_t seed = 1;
+    float    featureSize = 0.0f;      // tamanho típico (em células) das manchas de bioma; 0 = automático
+    float    itemDensity = 0.02f;     // fração das células caminháveis com item
+};
+
+struct MapItem {
+    int x, y, type;
+};
+
+struct GeneratedMap {
+    int                  width = 0, height = 0;
+    uint64_t             seed = 0;
+    std::vector<uint8_t> tiles, heights;   // linha a linha, height * width
+    std::vector<MapItem> items;            // em ordem de linha
+};
+
+namespace map_gen {
+
+const int CHUNK_ROWS = 32;
+const int MAX_HEIGHT = 3;   // IsometricTilemap: MAX_LEVELS - 1
+const int MAX_STEP = 1;     // IsometricTilemap: maior degrau que o jogador sobe/desce
+
+inline uint64_t mix(uint64_t z) {   // finalizador do splitmix64
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t cellHash(uint64_t seed, int64_t x, int64_t y) {
+    return mix(seed ^ (uint64_t(x) * 0x632BE59BD9B4E019ull) ^ (uint64_t(y) * 0x8CB92BA72F3D8DD7ull));
+}
+
+// Valor da grade de ruído em [0, 1)
+inline float lattice(uint64_t seed, int64_t x, int64_t y) {
+    return float(cellHash(seed, x, y) >> 40) * (1.0f / 16777216.0f);
+}
+
+inline float valueNoise(uint64_t seed, float x, float y) {
+    float fx = std::floor(x), fy = std::floor(y);
+    int64_t ix = int64_t(fx), iy = int64_t(fy);
+    float tx = x - fx, ty = y - fy;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    ty = ty * ty * (3.0f - 2.0f * ty);
+    float a = lattice(seed, ix, iy),     b = lattice(seed, ix + 1, iy);
+    float c = lattice(seed, ix, iy + 1), d = lattice(seed, ix + 1, iy + 1);
+    return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * ty;
+}
+
+// 4 oitavas, normalizado para [0, 1)
+inline float fbm(uint64_t seed, float x, float y) {
+    float sum = 0.0f, amp = 1.0f, norm = 0.0f;
+    for (int o = 0; o < 4; ++o) {
+        sum += amp * valueNoise(mix(seed + o), x, y);
+        norm += amp;
+        amp *= 0.5f;
+        x *= 2.0f;
+        y *= 2.0f;
+    }
+    return sum / norm;
+}
+
+inline bool isClearing(const MapGenParams& p, int x, int y) {
+    return std::abs(x - p.width / 2) <= 1 && std::abs(y - p.height / 2) <= 1;
+}
+
+inline void generateRows(const MapGenParams& p, int y0, int y1, GeneratedMap& out) {
+    const uint64_t elevSeed = mix(p.seed), moistSeed = mix(p.seed + 1);
+    // automático: manchas de até 24 células, menores em mapas pequenos
+    const float    feature = p.featureSize > 0.0f ? p.featureSize
+                                                  : std::min(24.0f, std::max(3.0f, std::min(p.width, p.height) / 4.0f));
+    const float    f = 1.0f / std::max(1.0f, feature);
+    const int      cx = p.width / 2, cy = p.height / 2;
+    const float    centerElev = fbm(elevSeed, cx * f, cy * f);
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = 0; x < p.width; ++x) {
+            // a clareira usa a elevação do centro, para o jogador não nascer preso
+            float e = isClearing(p, x, y) ? centerElev : fbm(elevSeed, x * f, y * f);
+            uint8_t tile;
+            if (e < 0.36f)      tile = 3;
+            else if (e < 0.42f) tile = 2;
+            else if (e < 0.60f) tile = fbm(moistSeed, x * f, y * f) < 0.5f ? 0 : 1;
+            else if (e < 0.68f) tile = 4;
+            else                tile = 5;
+            if (isClearing(p, x, y)) tile = 0;
+
+            // altura acompanha a elevação em degraus de um nível a partir da areia
+            int hgt = e < 0.50f ? 0 : std::min(MAX_HEIGHT, 1 + int((e - 0.50f) / 0.06f));
+
+            size_t c = size_t(y) * p.width + x;
+            out.tiles[c] = tile;
+            out.heights[c] = uint8_t(hgt);
+        }
+    }
+}
+
+// Células alcançáveis a partir do início (centro), como o IsometricTilemap move o
+// jogador: 8 vizinhos, degrau de até MAX_STEP níveis; montanha (5) bloqueia e água (3)
+// encerra o jogo, então nenhuma das duas entra no caminho
+inline std::vector<bool> reachableFromStart(const GeneratedMap& m) {
+    std::vector<bool> reach(m.tiles.size(), false);
+    auto passable = [&](size_t c) { return m.tiles[c] != 3 && m.tiles[c] != 5; };
+    const size_t start = size_t(m.height / 2) * m.width + m.width / 2;
+    if (!passable(start)) return reach;
+    std::deque<size_t> open = { start };
+    reach[start] = true;
+    while (!open.empty()) {
+        size_t c = open.front();
+        open.pop_front();
+        int x = int(c % m.width), y = int(c / m.width);
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx, ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= m.width || ny >= m.height) continue;
+                size_t n = size_t(ny) * m.width + nx;
+                if (reach[n] || !passable(n) || std::abs(m.heights[n] - m.heights[c]) > MAX_STEP) continue;
+                reach[n] = true;
+                open.push_back(n);
+            }
+    }
+    return reach;
+}
+
+inline void placeRowItems(const MapGenParams& p, const std::vector<bool>& reach, int y0, int y1,
+                          std::vector<MapItem>& items) {
+    const uint64_t itemSeed = mix(p.seed + 2);
+    const uint64_t itemCut = uint64_t(double(std::min(std::max(p.itemDensity, 0.0f), 1.0f)) * 4294967296.0);
+    for (int y = y0; y < y1; ++y)
+        for (int x = 0; x < p.width; ++x) {
+            uint64_t r = cellHash(itemSeed, x, y);
+            if (reach[size_t(y) * p.width + x] && !isClearing(p, x, y) && (r & 0xFFFFFFFFull) < itemCut)
+                items.push_back({ x, y, int((r >> 32) % 3) });
+        }
+}
+
+// Sem item nenhum o jogo não termina em vitória: usa a célula alcançável de menor
+// sorteio, fora da clareira se houver alguma (senão, na clareira, fora do início)
+inline void ensureOneItem(const MapGenParams& p, const std::vector<bool>& reach, std::vector<MapItem>& items) {
+    if (!items.empty()) return;
+    const uint64_t itemSeed = mix(p.seed + 2);
+    const int cx = p.width / 2, cy = p.height / 2;
+    bool     found = false, bestClearing = true;
+    uint64_t best = 0;
+    MapItem  pick{};
+    for (int y = 0; y < p.height; ++y)
+        for (int x = 0; x < p.width; ++x) {
+            if (!reach[size_t(y) * p.width + x] || (x == cx && y == cy)) continue;
+            bool     clearing = isClearing(p, x, y);
+            uint64_t r = cellHash(itemSeed, x, y);
+            bool better = !found || (bestClearing && !clearing) ||
+                          (clearing == bestClearing && (r & 0xFFFFFFFFull) < (best & 0xFFFFFFFFull));
+            if (better) {
+                found = true;
+                bestClearing = clearing;
+                best = r;
+                pick = { x, y, int((r >> 32) % 3) };
+            }
+        }
+    if (found) items.push_back(pick);
+}
+
+} // namespace map_gen
+
+inline void generateMap(const MapGenParams& p, JobSystem& jobs, GeneratedMap& out) {
+    out.width = p.width;
+    out.height = p.height;
+    out.seed = p.seed;
+    out.tiles.assign(size_t(p.width) * p.height, 0);
+    out.heights.assign(size_t(p.width) * p.height, 0);
+    out.items.clear();
+
+    size_t chunks = size_t(p.height + map_gen::CHUNK_ROWS - 1) / map_gen::CHUNK_ROWS;
+    jobs.wait(jobs.parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            int y0 = int(k) * map_gen::CHUNK_ROWS;
+            map_gen::generateRows(p, y0, std::min(p.height, y0 + map_gen::CHUNK_ROWS), out);
+        }
+    }));
+
+    // itens só onde o jogador chega; a busca é sequencial, o sorteio volta a ser por faixas
+    const std::vector<bool> reach = map_gen::reachableFromStart(out);
+    std::vector<std::vector<MapItem>> chunkItems(chunks);
+    jobs.wait(jobs.parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            int y0 = int(k) * map_gen::CHUNK_ROWS;
+            map_gen::placeRowItems(p, reach, y0, std::min(p.height, y0 + map_gen::CHUNK_ROWS), chunkItems[k]);
+        }
+    }));
+    for (const auto& ci : chunkItems) out.items.insert(out.items.end(), ci.begin(), ci.end());
+    map_gen::ensureOneItem(p, reach, out.items);
+}
+
+// FNV-1a de tiles, alturas e itens: mesmo mapa, mesmo valor
+inline uint64_t mapDigest(const GeneratedMap& m) {
+    uint64_t h = 1469598103934665603ull;
+    auto add = [&](const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+    };
+    add(m.tiles.data(), m.tiles.size());
+    add(m.heights.data(), m.heights.size());
+    for (const MapItem& it : m.items) add(&it, sizeof(it));
+    return h;
+}
+
+// Formato de map.txt: "altura largura", a grade de tiles, linha em branco e a grade de
+// alturas. As faixas são formatadas em paralelo (em grupos, para não segurar o arquivo
+// inteiro na memória) e gravadas em ordem
+inline bool writeMapText(const GeneratedMap& m, const std::string& path, JobSystem& jobs) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file << m.height << " " << m.width << "\n";
+
+    const size_t chunks = size_t(m.height + map_gen::CHUNK_ROWS - 1) / map_gen::CHUNK_ROWS;
+    const size_t group = 64;
+    std::vector<std::string> text(group);
+    for (int grid = 0; grid < 2; ++grid) {
+        const std::vector<uint8_t>& cells = grid == 0 ? m.tiles : m.heights;
+        if (grid == 1) file << "\n";
+        for (size_t g0 = 0; g0 < chunks; g0 += group) {
+            size_t g1 = std::min(chunks, g0 + group);
+            jobs.wait(jobs.parallelFor(g0, g1, 1, [&](size_t lo, size_t hi) {
+                for (size_t k = lo; k < hi; ++k) {
+                    std::string& s = text[k - g0];
+                    s.clear();
+                    int y0 = int(k) * map_gen::CHUNK_ROWS, y1 = std::min(m.height, y0 + map_gen::CHUNK_ROWS);
+                    for (int y = y0; y < y1; ++y) {
+                        const uint8_t* row = &cells[size_t(y) * m.width];
+                        for (int x = 0; x < m.width; ++x) {
+                            s += char('0' + row[x]);   // valores de um dígito (0-5, 0-3)
+                            s += x + 1 < m.width ? ' ' : '\n';
+                        }
+                    }
+                }
+            }));
+            for (size_t k = g0; k < g1; ++k) file.write(text[k - g0].data(), (std::streamsize)text[k - g0].size());
+        }
+    }
+    return bool(file);
+}
+
+inline bool writeItemsText(const GeneratedMap& m, const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << "# Gerado por MapGen (semente " << m.seed << ")\n";
+    file << "# X Y tipo (0 = Dark Red, 1 = White, 2 = Yellow Crystal)\n";
+    for (const MapItem& it : m.items) file << it.x << " " << it.y << " " << it.type << "\n";
+    return bool(file);
+}
+
+// Formato binário (map.bin), lido sem conversão de texto (IsometricTilemap --map):
+//   "IMAP" | versão u8 | largura u32 | altura u32 | semente u64 | tiles u8[] | alturas u8[]
+// inteiros em little-endian
+inline bool writeMapBinary(const GeneratedMap& m, const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    uint8_t header[4 + 1 + 4 + 4 + 8] = { 'I', 'M', 'A', 'P', 1 };
+    for (int i = 0; i < 4; ++i) header[5 + i] = uint8_t(uint32_t(m.width) >> (8 * i));
+    for (int i = 0; i < 4; ++i) header[9 + i] = uint8_t(uint32_t(m.height) >> (8 * i));
+    for (int i = 0; i < 8; ++i) header[13 + i] = uint8_t(m.seed >> (8 * i));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m.tiles.data()), (std::streamsize)m.tiles.size());
+    file.write(reinterpret_cast<const char*>(m.heights.data()), (std::streamsize)m.heights.size());
+    return bool(file);
+}
+
+inline bool readMapBinary(const std::string& path, GeneratedMap& m) {
+    std::ifstream file(path, std::ios::binary);
+    uint8_t header[21];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    if (std::string(reinterpret_cast<char*>(header), 4) != "IMAP" || header[4] != 1) return false;
+    uint32_t w = 0, h = 0;
+    uint64_t seed = 0;
+    for (int i = 0; i < 4; ++i) w |= uint32_t(header[5 + i]) << (8 * i);
+    for (int i = 0; i < 4; ++i) h |= uint32_t(header[9 + i]) << (8 * i);
+    for (int i = 0; i < 8; ++i) seed |= uint64_t(header[13 + i]) << (8 * i);
+    if (w == 0 || h == 0 || w > 65536 || h > 65536) return false;
+    m.width = int(w);
+    m.height = int(h);
+    m.seed = seed;
+    m.tiles.resize(size_t(w) * h);
+    m.heights.resize(size_t(w) * h);
+    m.items.clear();
+    file.read(reinterpret_cast<char*>(m.tiles.data()), (std::streamsize)m.tiles.size());
+    file.read(reinterpret_cast<char*>(m.heights.data()), (std::streamsize)m.heights.size());
+    return bool(file);
+}
@@ -0,0 +1,224 @@
+// render_target_pool.h
+// Alvos de renderização fora da tela (framebuffer + textura de cor + textura de
+// profundidade) reaproveitados por tamanho e formato.
+//
+// acquire() arredonda o tamanho pedido para cima em múltiplos de BUCKET e procura um
+// alvo livre com a mesma chave (largura, altura, formato de cor, com/sem profundidade);
+// só cria um novo se não houver. Quem desenha usa o canto (0,0) do tamanho que pediu
+// (glViewport/glScissor), então redimensionar a janela dentro do mesmo bucket, ou
+// mudar a escala da resolução, não realoca nada. Alvos devolvidos com release() ficam
+// no pool; endFrame() apaga os que passaram KEEP_FRAMES frames sem uso e, acima de
+// MAX_FREE livres, os mais antigos. Arrastar a borda da janela para lá e para cá
+// reaproveita os alvos dos tamanhos já vistos.
+//
+// Os objetos vêm dos pools de gl_resources.h (framebuffers e texturas).
+//
+// Uso:
+//   RenderTargetPool pool;
+//   RenderTarget rt = pool.acquire(w, h, GL_RGBA8);
+//   if (rt) glBindFramebuffer(GL_FRAMEBUFFER, rt.fbo);
+//   ...
+//   pool.release(rt);
+//   pool.endFrame();                     // uma vez por frame
+//   pool.clear();                        // antes do gl::shutdown()
+
+#pragma once
+
+#include "gl_resources.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+struct RenderTarget {
+    GLuint fbo = 0;      // sem posse: o pool é o dono
+    GLuint color = 0;
+    GLuint depth = 0;    // 0 se pedido sem profundidade
+    int    width = 0;    // tamanho alocado (múltiplo de BUCKET)
+    int    height = 0;
+    int    slot = -1;
+
+    explicit operator bool() const { return fbo != 0; }
+};
+
+class RenderTargetPool {
+public:
+    static constexpr int      BUCKET = 128;
+    static constexpr size_t   MAX_FREE = 4;
+    static constexpr uint64_t KEEP_FRAMES = 300;
+
+    // Tamanho alocado para um pedido de v pixels
+    static int bucketed(int v) {
+        if (v < 1) v = 1;
+        return (v + BUCKET - 1) / BUCKET * BUCKET;
+    }
+
+    RenderTargetPool() = default;
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // Alvo com pelo menos w x h; vazio (false) se o formato não é suportado ou o
+    // framebuffer fica incompleto
+    RenderTarget acquire(int w, int h, GLenum colorFormat = GL_RGBA8, bool withDepth = true) {
+        const int bw = bucketed(w), bh = bucketed(h);
+        int freeSlot = -1;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            Entry& e = entries[i];
+            if (!e.fbo) {
+                if (freeSlot < 0) freeSlot = int(i);
+                continue;
+            }
+            if (!e.inUse && e.width == bw && e.height == bh && e.format == colorFormat &&
+                bool(e.depth) == withDepth) {
+                e.inUse = true;
+                ++reusedCount;
+                return target(int(i));
+            }
+        }
+
+        GLenum fmt, type;
+        if (!pixelFormat(colorFormat, fmt, type)) return {};
+        Entry e;
+        e.width = bw;
+        e.height = bh;
+        e.format = colorFormat;
+        e.color = gl::Texture::create();
+        glBindTexture(GL_TEXTURE_2D, e.color);
+        glTexImage2D(GL_TEXTURE_2D, 0, GLint(colorFormat), bw, bh, 0, fmt, type, nullptr);
+        // ampliado com filtro linear na cópia para a janela
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        if (withDepth) {
+            e.depth = gl::Texture::create();
+            glBindTexture(GL_TEXTURE_2D, e.depth);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, bw, bh, 0, GL_DEPTH_COMPONENT,
+                         GL_UNSIGNED_INT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        e.fbo = gl::Framebuffer::create();
+        GLint bound = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound);
+        glBindFramebuffer(GL_FRAMEBUFFER, e.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, e.color, 0);
+        if (withDepth)
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, e.depth, 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)bound);
+        if (status != GL_FRAMEBUFFER_COMPLETE) return {};   // os handles voltam aos pools
+
+        e.inUse = true;
+        ++createdCount;
+        int slot = freeSlot;
+        if (slot < 0) {
+            slot = int(entries.size());
+            entries.push_back(std::move(e));
+        } else {
+            entries[slot] = std::move(e);
+        }
+        return target(slot);
+    }
+
+    // Devolve ao pool (continua alocado para o próximo acquire com a mesma chave)
+    void release(RenderTarget& rt) {
+        if (rt.slot >= 0 && size_t(rt.slot) < entries.size()) {
+            entries[rt.slot].inUse = false;
+            entries[rt.slot].lastUse = frame;
+        }
+        rt = {};
+    }
+
+    // Uma vez por frame: apaga os livres esquecidos
+    void endFrame() {
+        ++frame;
+        size_t freeCount = 0;
+        for (Entry& e : entries) {
+            if (!e.fbo || e.inUse) continue;
+            if (frame - e.lastUse > KEEP_FRAMES) evict(e);
+            else ++freeCount;
+        }
+        while (freeCount > MAX_FREE) {
+            Entry* oldest = nullptr;
+            for (Entry& e : entries)
+                if (e.fbo && !e.inUse && (!oldest || e.lastUse < oldest->lastUse)) oldest = &e;
+            evict(*oldest);
+            --freeCount;
+        }
+    }
+
+    // Devolve tudo aos pools de gl_resources.h
+    void clear() {
+        for (Entry& e : entries) evict(e);
+        entries.clear();
+    }
+
+    // Bytes de vídeo dos alvos vivos (estimativa: RGB8 conta como 4 bytes, como os drivers guardam)
+    size_t bytes() const {
+        size_t total = 0;
+        for (const Entry& e : entries) {
+            if (!e.fbo) continue;
+            size_t perPixel = (e.format == GL_RGBA16F ? 8 : 4) + (e.depth ? 4 : 0);
+            total += size_t(e.width) * size_t(e.height) * perPixel;
+        }
+        return total;
+    }
+
+    void report(std::ostream& os) const {
+        size_t live = 0;
+        for (const Entry& e : entries) live += e.fbo ? 1 : 0;
+        os << "Alvos de renderizacao: " << live << " vivos (" << bytes() / 1024 << " KB), "
+           << createdCount << " criados, " << reusedCount << " reaproveitados, "
+           << evictedCount << " apagados\n";
+    }
+
+private:
+    struct Entry {
+        gl::Framebuffer fbo;
+        gl::Texture     color, depth;
+        int             width = 0, height = 0;
+        GLenum          format = 0;
+        bool            inUse = false;
+        uint64_t        lastUse = 0;
+    };
+
+    static bool pixelFormat(GLenum internal, GLenum& fmt, GLenum& type) {
+        switch (internal) {
+            case GL_RGBA8:   fmt = GL_RGBA; type = GL_UNSIGNED_BYTE; return true;
+            case GL_RGB8:    fmt = GL_RGB;  type = GL_UNSIGNED_BYTE; return true;
+            case GL_RGBA16F: fmt = GL_RGBA; type = GL_HALF_FLOAT;    return true;
+            default:         return false;
+        }
+    }
+
+    RenderTarget target(int slot) const {
+        const Entry& e = entries[slot];
+        RenderTarget rt;
+        rt.fbo = e.fbo;
+        rt.color = e.color;
+        rt.depth = e.depth;
+        rt.width = e.width;
+        rt.height = e.height;
+        rt.slot = slot;
+        return rt;
+    }
+
+    void evict(Entry& e) {
+        if (!e.fbo) return;
+        e.fbo.reset();
+        e.color.reset();
+        e.depth.reset();
+        e.width = e.height = 0;
+        e.inUse = false;
+        ++evictedCount;
+    }
+
+    std::vector<Entry> entries;   // posições vagas (fbo == 0) são reutilizadas
+    uint64_t           frame = 0;
+    unsigned long      createdCount = 0, reusedCount = 0, evictedCount = 0;
+};
@@ -0,0 +1,128 @@
+// scene_graph.h
+// Hierarquia de transformações 2D com matrizes de mundo em cache.
+// Os nós ficam em um vetor plano ordenado por profundidade (raízes, depois filhos
+// diretos, depois netos...), então todo pai vem antes dos filhos e a atualização é
+// uma única passada linear. Só nós marcados como sujos (e seus descendentes) são
+// recalculados; se nada mudou, update() retorna sem percorrer nada.
+//
+// Uso:
+//   SceneGraph scene;
+//   auto player = scene.add(SceneGraph::NONE, 400, 300);          // âncora (só posição)
+//   auto sprite = scene.add(player, 0, 0, 64, 64);                // segue o jogador
+//   scene.translate(player, dx, dy);
+//   scene.update();                                               // uma vez por frame
+//   glUniform3fv(locModel, 2, scene.world(sprite).rows());
+
+#pragma once
+
+#include "transform2d.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class SceneGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NONE = ~0u;
+
+    // Acrescenta um nó com transformação local (x, y, escala w×h, rotação em graus)
+    // relativa ao pai; NONE cria uma raiz
+    NodeId add(NodeId parent, float x, float y, float w = 1.0f, float h = 1.0f, float degrees = 0.0f) {
+        int    pslot = parent == NONE ? -1 : (int)slotOf[parent];
+        int    d     = pslot < 0 ? 0 : depth[pslot] + 1;
+        size_t pos   = std::upper_bound(depth.begin(), depth.end(), d) - depth.begin();
+
+        // abre espaço no fim do bloco da profundidade d; tudo depois anda uma posição
+        NodeId id = (NodeId)slotOf.size();
+        slotOf.push_back((uint32_t)pos);
+        for (size_t s = pos; s < idOf.size(); ++s) ++slotOf[idOf[s]];
+        for (int& p : parentSlot) if (p >= (int)pos) ++p;
+
+        idOf.insert(idOf.begin() + pos, id);
+        parentSlot.insert(parentSlot.begin() + pos, pslot);
+        depth.insert(depth.begin() + pos, d);
+        local.px.insert(local.px.begin() + pos, x);
+        local.py.insert(local.py.begin() + pos, y);
+        local.sx.insert(local.sx.begin() + pos, w);
+        local.sy.insert(local.sy.begin() + pos, h);
+        local.rot.insert(local.rot.begin() + pos, degrees);
+        worlds.insert(worlds.begin() + pos, Affine2D{});
+        dirty.insert(dirty.begin() + pos, 1);
+        if (firstDirty != NO_DIRTY && firstDirty >= pos) ++firstDirty;
+        markDirty(pos);
+        return id;
+    }
+
+    void setTransform(NodeId n, float x, float y, float w, float h, float degrees = 0.0f) {
+        size_t s = slotOf[n];
+        local.set(s, x, y, w, h, degrees);
+        markDirty(s);
+    }
+    void setPosition(NodeId n, float x, float y) {
+        size_t s = slotOf[n];
+        local.px[s] = x;  local.py[s] = y;
+        markDirty(s);
+    }
+    void translate(NodeId n, float dx, float dy) {
+        size_t s = slotOf[n];
+        local.px[s] += dx;  local.py[s] += dy;
+        markDirty(s);
+    }
+    void setScale(NodeId n, float w, float h) {
+        size_t s = slotOf[n];
+        local.sx[s] = w;  local.sy[s] = h;
+        markDirty(s);
+    }
+    void setRotation(NodeId n, float degrees) {
+        size_t s = slotOf[n];
+        local.rot[s] = degrees;
+        markDirty(s);
+    }
+
+    float x(NodeId n) const { return local.px[slotOf[n]]; }
+    float y(NodeId n) const { return local.py[slotOf[n]]; }
+
+    // Matriz de mundo em cache (válida após update())
+    const Affine2D& world(NodeId n) const { return worlds[slotOf[n]]; }
+
+    size_t size() const { return idOf.size(); }
+
+    // Recalcula os nós sujos e os descendentes deles; devolve quantos foram recalculados
+    size_t update() {
+        if (firstDirty == NO_DIRTY) return 0;
+        size_t n = idOf.size(), count = 0;
+        for (size_t s = firstDirty; s < n; ++s) {
+            int p = parentSlot[s];
+            if (!dirty[s] && !(p >= 0 && dirty[p])) continue;
+            dirty[s] = 1;   // propaga para os filhos, que vêm depois
+            Affine2D l = affineAt(local, s);
+            worlds[s] = p >= 0 ? worlds[p] * l : l;
+            ++count;
+        }
+        std::memset(&dirty[firstDirty], 0, n - firstDirty);
+        firstDirty = NO_DIRTY;
+        return count;
+    }
+
+private:
+    static constexpr size_t NO_DIRTY = ~size_t(0);
+
+    void markDirty(size_t s) {
+        dirty[s] = 1;
+        firstDirty = std::min(firstDirty, s);
+    }
+
+    // por nó (id estável) -> posição no vetor plano
+    std::vector<uint32_t> slotOf;
+
+    // por posição, em ordem de profundidade
+    std::vector<NodeId>   idOf;
+    std::vector<int>      parentSlot;
+    std::vector<int>      depth;
+    Transform2DBatch      local;    // transformações locais em SoA
+    std::vector<Affine2D> worlds;
+    std::vector<uint8_t>  dirty;
+    size_t                firstDirty = NO_DIRTY;
+};
@@ -0,0 +1,123 @@
+// snapshot.h
+// Escrita/leitura binária compacta para arquivos de save.
+// Inteiros sem sinal vão como varint (7 bits por byte, o bit alto diz se continua);
+// com sinal passam antes por zigzag (0, -1, 1, -2... viram 0, 1, 2, 3...), então
+// valores pequenos, positivos ou negativos, ocupam um byte. Deltas em relação a uma
+// base (índices crescentes, valor - valor base) quase sempre cabem em um ou dois bytes.
+//
+// ByteReader nunca lê além do fim: qualquer leitura inválida deixa ok() falso e
+// devolve 0, então basta conferir ok() no final.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ByteWriter {
+public:
+    void u8(uint8_t v) { bytes.push_back(v); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; ++i) u8(uint8_t(v >> (8 * i))); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; ++i) u8(uint8_t(v >> (8 * i))); }
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            u8(uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        u8(uint8_t(v));
+    }
+    void svarint(int64_t v) { varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    void raw(const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        bytes.insert(bytes.end(), b, b + n);
+    }
+
+    const std::vector<uint8_t>& data() const { return bytes; }
+
+    // Grava em path + ".tmp" e renomeia, para um save interrompido não estragar o anterior
+    bool writeFile(const std::string& path) const {
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f) return false;
+            f.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+            if (!f) return false;
+        }
+        std::remove(path.c_str());
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    std::vector<uint8_t> bytes;
+};
+
+class ByteReader {
+public:
+    explicit ByteReader(std::vector<uint8_t> data) : bytes(std::move(data)) {}
+
+    static bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return false;
+        out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    bool ok() const { return good; }
+    bool atEnd() const { return pos == bytes.size(); }
+
+    uint8_t u8() {
+        if (pos >= bytes.size()) { good = false; return 0; }
+        return bytes[pos++];
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= uint32_t(u8()) << (8 * i);
+        return v;
+    }
+    uint64_t u64() {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= uint64_t(u8()) << (8 * i);
+        return v;
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = u8();
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;   // mais de 10 bytes: corrompido
+        return 0;
+    }
+    int64_t svarint() {
+        uint64_t v = varint();
+        return int64_t(v >> 1) ^ -int64_t(v & 1);
+    }
+    bool raw(void* p, size_t n) {
+        if (bytes.size() - pos < n) { good = false; return false; }
+        std::copy(bytes.begin() + pos, bytes.begin() + pos + n, static_cast<uint8_t*>(p));
+        pos += n;
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t               pos = 0;
+    bool                 good = true;
+};
+
+// FNV-1a de 64 bits, para conferir que o save corresponde ao mesmo mapa base
+inline uint64_t fnv1a(const void* p, size_t n, uint64_t h = 1469598103934665603ull) {
+    const uint8_t* b = static_cast<const uint8_t*>(p);
+    for (size_t i = 0; i < n; ++i) {
+        h ^= b[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
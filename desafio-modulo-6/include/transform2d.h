@@ -0,0 +1,164 @@
+// transform2d.h
+// Transformações 2D compactas para sprites.
+// Posição, rotação (graus) e escala ficam em SoA (um vetor por campo); um kernel em lote
+// calcula a matriz afim 2x3 de todos os sprites de uma vez (SSE2 quando disponível, 4 por
+// iteração). Cada sprite envia só 6 floats (24 bytes) em vez de uma mat4 (64 bytes).
+//
+// No shader a matriz chega como duas linhas:
+//   uniform vec3 model[2];
+//   vec3 p = vec3(aPos, 1.0);
+//   vec2 world = vec2(dot(model[0], p), dot(model[1], p));
+// e é enviada com glUniform3fv(locModel, 2, affine.rows()).
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORM2D_SSE2 1
+#endif
+
+// Matriz afim em um só vetor, as duas linhas seguidas (rows() serve os 6 floats):
+//   x' = v[0]*x + v[1]*y + v[2], y' = v[3]*x + v[4]*y + v[5]
+struct Affine2D {
+    float v[6];
+
+    const float* rows() const { return v; }
+};
+
+struct Transform2DBatch {
+    std::vector<float> px, py;   // translação
+    std::vector<float> rot;      // rotação em graus (como glm::rotate(glm::radians(rot)))
+    std::vector<float> sx, sy;   // escala
+
+    size_t size() const { return px.size(); }
+
+    size_t add(float x, float y, float w, float h, float degrees = 0.0f) {
+        px.push_back(x);  py.push_back(y);
+        sx.push_back(w);  sy.push_back(h);
+        rot.push_back(degrees);
+        return px.size() - 1;
+    }
+
+    void set(size_t i, float x, float y, float w, float h, float degrees = 0.0f) {
+        px[i] = x;  py[i] = y;
+        sx[i] = w;  sy[i] = h;
+        rot[i] = degrees;
+    }
+
+    void clear() {
+        px.clear(); py.clear(); rot.clear(); sx.clear(); sy.clear();
+    }
+};
+
+namespace transform2d_detail {
+
+// seno/cosseno com redução ao quadrante e polinômios de [-pi/4, pi/4] (estilo Cephes);
+// erro ~1e-7, mesmo resultado no caminho escalar e no SSE2
+const float TWO_OVER_PI = 0.636619772367581343f;
+const float DP1 = 1.5703125f;
+const float DP2 = 4.837512969970703125e-4f;
+const float DP3 = 7.54978995489188216e-8f;
+const float DEG2RAD = 0.0174532925199432958f;
+
+inline void sincosScalar(float x, float& s, float& c) {
+    int   j  = (int)(x * TWO_OVER_PI + (x >= 0 ? 0.5f : -0.5f));
+    float jf = (float)j;
+    float y  = ((x - jf * DP1) - jf * DP2) - jf * DP3;
+    float z  = y * y;
+    float ps = y + y * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+    float pc = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+    switch (j & 3) {
+        case 0: s =  ps; c =  pc; break;
+        case 1: s =  pc; c = -ps; break;
+        case 2: s = -ps; c = -pc; break;
+        default: s = -pc; c = ps; break;
+    }
+}
+
+inline void affineScalar(const Transform2DBatch& b, size_t i, Affine2D& out) {
+    float s, c;
+    sincosScalar(b.rot[i] * DEG2RAD, s, c);
+    out.v[0] = c * b.sx[i];  out.v[1] = -s * b.sy[i];  out.v[2] = b.px[i];
+    out.v[3] = s * b.sx[i];  out.v[4] =  c * b.sy[i];  out.v[5] = b.py[i];
+}
+
+} // namespace transform2d_detail
+
+// Calcula as matrizes de [first, first+count) em out[first..]
+inline void computeAffines(const Transform2DBatch& b, Affine2D* out, size_t first, size_t count) {
+    using namespace transform2d_detail;
+    size_t i = first, end = first + count;
+#ifdef TRANSFORM2D_SSE2
+    const __m128 twoOverPi = _mm_set1_ps(TWO_OVER_PI);
+    const __m128 deg2rad   = _mm_set1_ps(DEG2RAD);
+    const __m128 dp1 = _mm_set1_ps(DP1), dp2 = _mm_set1_ps(DP2), dp3 = _mm_set1_ps(DP3);
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    for (; i + 4 <= end; i += 4) {
+        __m128 x  = _mm_mul_ps(_mm_loadu_ps(&b.rot[i]), deg2rad);
+        __m128i j = _mm_cvtps_epi32(_mm_mul_ps(x, twoOverPi));   // arredonda ao mais próximo
+        __m128 jf = _mm_cvtepi32_ps(j);
+        __m128 y  = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(jf, dp1)), _mm_mul_ps(jf, dp2)), _mm_mul_ps(jf, dp3));
+        __m128 z  = _mm_mul_ps(y, y);
+
+        __m128 ps = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(z, _mm_set1_ps(-1.9515295891e-4f)));
+        ps = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(z, ps));
+        ps = _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(y, z), ps));
+
+        __m128 pc = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(z, _mm_set1_ps(2.443315711809948e-5f)));
+        pc = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(z, pc));
+        pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), pc));
+
+        // quadrantes ímpares trocam seno/cosseno; os bits de sinal vêm de j e j+1
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+        __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, two), 30));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), two), 30));
+        __m128 s = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+        __m128 c = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+        s = _mm_xor_ps(s, sinSign);
+        c = _mm_xor_ps(c, cosSign);
+
+        __m128 sx = _mm_loadu_ps(&b.sx[i]);
+        __m128 sy = _mm_loadu_ps(&b.sy[i]);
+        alignas(16) float lanes[6][4];
+        _mm_store_ps(lanes[0], _mm_mul_ps(c, sx));
+        _mm_store_ps(lanes[1], _mm_mul_ps(_mm_xor_ps(s, _mm_set1_ps(-0.0f)), sy));
+        _mm_store_ps(lanes[2], _mm_loadu_ps(&b.px[i]));
+        _mm_store_ps(lanes[3], _mm_mul_ps(s, sx));
+        _mm_store_ps(lanes[4], _mm_mul_ps(c, sy));
+        _mm_store_ps(lanes[5], _mm_loadu_ps(&b.py[i]));
+        for (int k = 0; k < 4; ++k) {
+            Affine2D& o = out[i + k];
+            o.v[0] = lanes[0][k]; o.v[1] = lanes[1][k]; o.v[2] = lanes[2][k];
+            o.v[3] = lanes[3][k]; o.v[4] = lanes[4][k]; o.v[5] = lanes[5][k];
+        }
+    }
+#endif
+    for (; i < end; ++i) affineScalar(b, i, out[i]);
+}
+
+inline void computeAffines(const Transform2DBatch& b, std::vector<Affine2D>& out) {
+    out.resize(b.size());
+    computeAffines(b, out.data(), 0, b.size());
+}
+
+// Composição: (p * l) aplica primeiro l e depois p (pai * local = mundo)
+inline Affine2D operator*(const Affine2D& p, const Affine2D& l) {
+    Affine2D w;
+    w.v[0] = p.v[0] * l.v[0] + p.v[1] * l.v[3];
+    w.v[1] = p.v[0] * l.v[1] + p.v[1] * l.v[4];
+    w.v[2] = p.v[0] * l.v[2] + p.v[1] * l.v[5] + p.v[2];
+    w.v[3] = p.v[3] * l.v[0] + p.v[4] * l.v[3];
+    w.v[4] = p.v[3] * l.v[1] + p.v[4] * l.v[4];
+    w.v[5] = p.v[3] * l.v[2] + p.v[4] * l.v[5] + p.v[5];
+    return w;
+}
+
+// Afim de um único elemento do lote
+inline Affine2D affineAt(const Transform2DBatch& b, size_t i) {
+    Affine2D a;
+    transform2d_detail::affineScalar(b, i, a);
+    return a;
+}
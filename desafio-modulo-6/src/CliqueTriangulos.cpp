@@ -1,15 +1,30 @@
 // CliqueTriangulos.cpp
 // OpenGL 3.3 + GLFW + GLAD + GLM
 // A cada clique um vértice, a cada 3 vértices um triângulo de cor diferente.
+// Todos os triângulos ficam em um único VBO que cresce geometricamente (a cor é
+// atributo de vértice) e são desenhados com uma só chamada.
+//
+// Teste de carga: CliqueTriangulos --stress N [--legacy]
+// injeta N cliques sintéticos e mede memória e tempo de frame; --legacy usa o
+// caminho antigo (um VAO/VBO por triângulo) para comparação.
+// Teclas: C limpa todos os triângulos, R imprime os objetos GL vivos.
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "gl_resources.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include <iostream>
-#include <cstdlib>''
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 // Janela
 const unsigned int SCR_W = 800, SCR_H = 600;
@@ -20,33 +35,105 @@ std::vector<glm::vec3> palette = {
 };
 int nextColor = 0;
 
+std::vector<glm::vec2> pendingVerts;
+
+// ——————————————————————
+// Buffer de vértices compartilhado e crescente
+struct Vertex {
+    glm::vec2 pos;
+    glm::vec3 color;
+};
+
+struct TriangleBuffer {
+    gl::VertexArray VAO;
+    gl::Buffer      VBO;
+    GLsizeiptr capacity = 0;   // em vértices
+    GLsizei    count    = 0;   // vértices em uso
+
+    void init(GLsizeiptr initialCapacity = 3 * 64) {
+        VAO = gl::VertexArray::create();
+        VBO = gl::Buffer::create();
+        count = 0;
+        glBindVertexArray(VAO);
+          glBindBuffer(GL_ARRAY_BUFFER,VBO);
+          glBufferData(GL_ARRAY_BUFFER,initialCapacity*sizeof(Vertex),nullptr,GL_DYNAMIC_DRAW);
+          setupAttributes();
+        glBindVertexArray(0);
+        capacity = initialCapacity;
+    }
+
+    void setupAttributes() {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,sizeof(Vertex),(void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,sizeof(Vertex),(void*)(2*sizeof(float)));
+    }
+
+    // Dobra a capacidade copiando o conteúdo antigo na própria GPU
+    // (sem cópia espelhada na CPU); o buffer antigo volta ao pool no fim do frame
+    void grow(GLsizeiptr minCapacity) {
+        GLsizeiptr newCap = capacity;
+        while (newCap < minCapacity) newCap *= 2;
+        gl::Buffer newVBO = gl::Buffer::create();
+        glBindBuffer(GL_COPY_WRITE_BUFFER,newVBO);
+        glBufferData(GL_COPY_WRITE_BUFFER,newCap*sizeof(Vertex),nullptr,GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER,VBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER,GL_COPY_WRITE_BUFFER,0,0,count*sizeof(Vertex));
+        VBO = std::move(newVBO);
+        capacity = newCap;
+
+        glBindVertexArray(VAO);
+          glBindBuffer(GL_ARRAY_BUFFER,VBO);
+          setupAttributes();
+        glBindVertexArray(0);
+    }
+
+    void append(const Vertex* v, GLsizei n) {
+        if (count + n > capacity) grow(count + n);
+        glBindBuffer(GL_ARRAY_BUFFER,VBO);
+        glBufferSubData(GL_ARRAY_BUFFER,count*sizeof(Vertex),n*sizeof(Vertex),v);
+        count += n;
+    }
+
+    void draw() const {
+        if (count == 0) return;
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES,0,count);
+    }
+
+    size_t gpuBytes() const { return size_t(capacity) * sizeof(Vertex); }
+};
+TriangleBuffer triBuffer;
+
+// ——————————————————————
+// Caminho antigo (um VAO/VBO por triângulo), mantido só para --legacy
 struct Triangle {
-    GLuint VAO;
+    gl::VertexArray VAO;
+    gl::Buffer      VBO;
     glm::vec3 color;
 };
 std::vector<Triangle> triangles;
+bool useLegacy = false;
 
-std::vector<glm::vec2> pendingVerts;
-
-GLuint makeTriangleVAO(const glm::vec2 v0,
-                       const glm::vec2 v1,
-                       const glm::vec2 v2)
+Triangle makeTriangle(const glm::vec2 v0,
+                      const glm::vec2 v1,
+                      const glm::vec2 v2,
+                      const glm::vec3 color)
 {
     float verts[] = {
         v0.x, v0.y,
         v1.x, v1.y,
         v2.x, v2.y
     };
-    GLuint VAO, VBO;
-    glGenVertexArrays(1,&VAO);
-    glGenBuffers     (1,&VBO);
+    Triangle tri{ gl::VertexArray::create(), gl::Buffer::create(), color };
+    GLuint VAO = tri.VAO, VBO = tri.VBO;
     glBindVertexArray(VAO);
       glBindBuffer(GL_ARRAY_BUFFER,VBO);
       glBufferData(GL_ARRAY_BUFFER,sizeof(verts),verts,GL_STATIC_DRAW);
       glEnableVertexAttribArray(0);
       glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,2*sizeof(float),(void*)0);
     glBindVertexArray(0);
-    return VAO;
+    return tri;
 }
 
 // ——————————————————————
@@ -54,17 +141,22 @@ GLuint makeTriangleVAO(const glm::vec2 v0,
 const char* vs_src = R"(
 #version 330 core
 layout(location=0) in vec2 aPos;
+layout(location=1) in vec3 aColor;
 uniform mat4 projection;
+uniform bool uUseAttribColor;
+uniform vec3 uColor;
+out vec3 vColor;
 void main(){
+    vColor = uUseAttribColor ? aColor : uColor;
     gl_Position = projection * vec4(aPos,0,1);
 }
 )";
 const char* fs_src = R"(
 #version 330 core
+in vec3 vColor;
 out vec4 Frag;
-uniform vec3 uColor;
 void main(){
-    Frag = vec4(uColor,1);
+    Frag = vec4(vColor,1);
 }
 )";
 
@@ -78,10 +170,10 @@ GLuint compileShader(GLenum t,const char* src){
     }
     return s;
 }
-GLuint makeProgram(){
+gl::Program makeProgram(){
     GLuint vs=compileShader(GL_VERTEX_SHADER,vs_src),
-           fs=compileShader(GL_FRAGMENT_SHADER,fs_src),
-           p=glCreateProgram();
+           fs=compileShader(GL_FRAGMENT_SHADER,fs_src);
+    gl::Program p=gl::Program::create();
     glAttachShader(p,vs); glAttachShader(p,fs);
     glLinkProgram(p);
     glDeleteShader(vs); glDeleteShader(fs);
@@ -89,27 +181,85 @@ GLuint makeProgram(){
 }
 
 // ——————————————————————
+// Registra um vértice (coordenadas de mundo, origem no canto inferior esquerdo)
+void addClick(float x,float y){
+    pendingVerts.emplace_back(x,y);
+    if(pendingVerts.size()==3){
+        glm::vec3 color = palette[nextColor];
+        if(useLegacy){
+            triangles.push_back(makeTriangle(
+                pendingVerts[0],
+                pendingVerts[1],
+                pendingVerts[2],
+                color
+            ));
+        } else {
+            Vertex v[3] = {
+                { pendingVerts[0], color },
+                { pendingVerts[1], color },
+                { pendingVerts[2], color }
+            };
+            triBuffer.append(v,3);
+        }
+        nextColor = (nextColor+1) % palette.size();
+        pendingVerts.clear();
+    }
+}
+
 // Callback de clique
 void mouse_cb(GLFWwindow* w,int button,int action,int mods){
     if(button!=GLFW_MOUSE_BUTTON_LEFT||action!=GLFW_PRESS) return;
     double x,y; glfwGetCursorPos(w,&x,&y);
     // converte para coordenadas de mundo (origem no canto inferior esquerdo):
     y = SCR_H - y;
-    pendingVerts.emplace_back((float)x,(float)y);
-    if(pendingVerts.size()==3){
-        // cria triângulo
-        GLuint VAO = makeTriangleVAO(
-            pendingVerts[0],
-            pendingVerts[1],
-            pendingVerts[2]
-        );
-        triangles.push_back({ VAO, palette[nextColor] });
-        nextColor = (nextColor+1) % palette.size();
+    addClick((float)x,(float)y);
+}
+
+// Teclado: C limpa os triângulos (os objetos voltam ao pool), R imprime o relatório
+void key_cb(GLFWwindow* w,int key,int scancode,int action,int mods){
+    if(action!=GLFW_PRESS) return;
+    if(key==GLFW_KEY_C){
+        triangles.clear();
         pendingVerts.clear();
+        triBuffer.init();
+    } else if(key==GLFW_KEY_R){
+        gl::reportLiveObjects(std::cout);
     }
 }
 
-int main(){
+// Memória residente do processo em bytes (Linux); 0 se indisponível
+size_t residentBytes(){
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if(!(statm >> pages >> resident)) return 0;
+    long pageSize = sysconf(_SC_PAGESIZE);   // 4 KiB na maioria, 16/64 KiB em alguns ARM
+    return pageSize > 0 ? resident * size_t(pageSize) : 0;
+#else
+    return 0;
+#endif
+}
+
+void drawScene(GLint locColor){
+    if(useLegacy){
+        for(auto &tri : triangles){
+            glUniform3fv(locColor,1,glm::value_ptr(tri.color));
+            glBindVertexArray(tri.VAO);
+            glDrawArrays(GL_TRIANGLES,0,3);
+        }
+    } else {
+        triBuffer.draw();
+    }
+}
+
+int main(int argc,char** argv){
+    long stressClicks = 0;
+    for(int i=1;i<argc;++i){
+        std::string a = argv[i];
+        if(a=="--stress" && i+1<argc) stressClicks = std::atol(argv[++i]);
+        else if(a=="--legacy")        useLegacy = true;
+    }
+
     // GLFW + contexto
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
@@ -121,14 +271,52 @@ int main(){
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
     // setup
-    GLuint program = makeProgram();
+    gl::Program program = makeProgram();
     GLint locProj = glGetUniformLocation(program,"projection");
     GLint locColor= glGetUniformLocation(program,"uColor");
+    GLint locUseAttr = glGetUniformLocation(program,"uUseAttribColor");
     glm::mat4 proj = glm::ortho(0.0f,(float)SCR_W,0.0f,(float)SCR_H,-1.0f,1.0f);
     glUseProgram(program);
     glUniformMatrix4fv(locProj,1,GL_FALSE,glm::value_ptr(proj));
+    glUniform1i(locUseAttr,useLegacy ? 0 : 1);
 
+    triBuffer.init();
     glfwSetMouseButtonCallback(win,mouse_cb);
+    glfwSetKeyCallback(win,key_cb);
+
+    if(stressClicks > 0){
+        // Injeta cliques sintéticos pelo mesmo caminho do callback
+        size_t rssBefore = residentBytes();
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dx(0.0f,(float)SCR_W), dy(0.0f,(float)SCR_H);
+        auto t0 = std::chrono::steady_clock::now();
+        for(long i=0;i<stressClicks;++i) addClick(dx(rng),dy(rng));
+        glFinish();
+        auto t1 = std::chrono::steady_clock::now();
+
+        const int frames = 60;
+        for(int f=0;f<frames;++f){
+            glClearColor(0.1f,0.1f,0.1f,1);
+            glClear(GL_COLOR_BUFFER_BIT);
+            drawScene(locColor);
+            glFinish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        size_t nTris = useLegacy ? triangles.size() : size_t(triBuffer.count / 3);
+        size_t vertexBytes = useLegacy ? nTris * 6 * sizeof(float) : triBuffer.gpuBytes();
+        std::cout << "Modo: " << (useLegacy ? "legado (VAO/VBO por triangulo)" : "VBO compartilhado") << "\n"
+                  << "Cliques: " << stressClicks << "  Triangulos: " << nTris << "\n"
+                  << "Objetos GL: " << (useLegacy ? nTris * 2 : 2) << "  Bytes de vertices na GPU: " << vertexBytes << "\n"
+                  << "RSS do processo: " << ((long long)residentBytes() - (long long)rssBefore) / 1024 << " KiB a mais\n"
+                  << "Insercao: " << std::chrono::duration<double,std::milli>(t1 - t0).count() << " ms\n"
+                  << "Frame medio: " << std::chrono::duration<double,std::milli>(t2 - t1).count() / frames << " ms\n";
+        gl::collectGarbage();
+        gl::reportLiveObjects(std::cout);
+        gl::shutdown();
+        glfwTerminate();
+        return 0;
+    }
 
     // loop
     while(!glfwWindowShouldClose(win)){
@@ -137,15 +325,14 @@ int main(){
         glClear(GL_COLOR_BUFFER_BIT);
 
         glUseProgram(program);
-        for(auto &tri : triangles){
-            glUniform3fv(locColor,1,glm::value_ptr(tri.color));
-            glBindVertexArray(tri.VAO);
-            glDrawArrays(GL_TRIANGLES,0,3);
-        }
+        drawScene(locColor);
 
         glfwSwapBuffers(win);
+        gl::collectGarbage();
     }
 
+    gl::reportLiveObjects(std::cout);
+    gl::shutdown();
     glfwTerminate();
     return 0;
 }
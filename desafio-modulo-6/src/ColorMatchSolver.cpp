@@ -0,0 +1,306 @@
+// ColorMatchSolver.cpp
+// Resolve uma grade do GameColorMatch: procura a sequência de até MAX_ATTEMPTS cliques
+// que remove o maior número de retângulos (regra original: cada clique remove todas as
+// cores vivas a distância <= limiar da cor clicada).
+//
+// Busca em profundidade com branch-and-bound sobre estados em bitset (células vivas),
+// distribuída entre os núcleos por um agendador com roubo de trabalho e com tabela de
+// transposição para estados já visitados. Se o tempo limite estourar, informa a melhor
+// sequência encontrada em vez da ótima.
+//
+// Uso: ColorMatchSolver [--cols N] [--rows N] [--seed S] [--threshold T]
+//                       [--attempts N] [--threads N] [--time SEG] [--memo-mb MB]
+// Com a mesma semente, "GameColorMatch S" gera a mesma grade (8x6).
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Bits = std::vector<uint64_t>;
+
+struct Options {
+    int      cols      = 8;
+    int      rows      = 6;
+    unsigned seed      = 0;
+    bool     hasSeed   = false;
+    float    threshold = 0.25f;
+    int      attempts  = 10;
+    unsigned threads   = 0;
+    double   timeLimit = 30.0;
+    size_t   memoMB    = 512;
+};
+
+// Mesmo gerador do GameColorMatch::initGrid (ordem y, x; r, g, b)
+std::vector<float> generateColors(const Options& opt) {
+    std::mt19937 rng{ opt.seed };
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> rgb;
+    rgb.reserve(size_t(opt.cols) * opt.rows * 3);
+    for (int y = 0; y < opt.rows; ++y)
+        for (int x = 0; x < opt.cols; ++x)
+            for (int c = 0; c < 3; ++c)
+                rgb.push_back(dist(rng));
+    return rgb;
+}
+
+struct BitsHash {
+    size_t operator()(const Bits& b) const {
+        uint64_t h = 1469598103934665603ull;
+        for (uint64_t w : b) {
+            h ^= w + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        }
+        return (size_t)h;
+    }
+};
+
+// Tabela de transposição: estado -> maior número de cliques restantes com que já foi
+// explorado. A pontuação acumulada é função do estado (n - vivos), então revisitar um
+// estado com igual ou menos cliques restantes nunca melhora o resultado.
+class TranspositionTable {
+public:
+    TranspositionTable(size_t maxBytes, size_t words)
+        : maxEntries(std::max<size_t>(1, maxBytes / (words * 8 + 64))) {}
+
+    // true se o estado já foi (ou está sendo) explorado com >= "left" cliques
+    bool visit(const Bits& alive, int left) {
+        size_t h = BitsHash{}(alive);
+        Shard& s = shards[h % SHARDS];
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it = s.map.find(alive);
+        if (it != s.map.end()) {
+            if (it->second >= left) return true;
+            it->second = left;
+            return false;
+        }
+        if (entries.load(std::memory_order_relaxed) < maxEntries) {
+            s.map.emplace(alive, left);
+            entries.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    size_t size() const { return entries.load(); }
+
+private:
+    static const size_t SHARDS = 64;
+    struct Shard {
+        std::mutex m;
+        std::unordered_map<Bits, int, BitsHash> map;
+    };
+    Shard               shards[SHARDS];
+    std::atomic<size_t> entries{0};
+    size_t              maxEntries;
+};
+
+class Solver {
+public:
+    Solver(const Options& o, const std::vector<float>& rgb)
+        : opt(o), n(o.cols * o.rows), words((n + 63) / 64),
+          memo(o.memoMB * 1024 * 1024, (n + 63) / 64) {
+        // similar[c] = células a distância <= limiar da cor de c (inclui c)
+        similar.assign(n, Bits(words, 0));
+        float t2 = opt.threshold * opt.threshold;
+        for (int a = 0; a < n; ++a) {
+            for (int b = a; b < n; ++b) {
+                float dr = rgb[a*3] - rgb[b*3], dg = rgb[a*3+1] - rgb[b*3+1], db = rgb[a*3+2] - rgb[b*3+2];
+                if (dr*dr + dg*dg + db*db <= t2) {
+                    similar[a][b >> 6] |= 1ull << (b & 63);
+                    similar[b][a >> 6] |= 1ull << (a & 63);
+                }
+            }
+        }
+    }
+
+    void run() {
+        start = std::chrono::steady_clock::now();
+        Bits all(words, ~0ull);
+        if (n % 64) all.back() = (1ull << (n % 64)) - 1;
+
+        greedy(all);
+
+        JobSystem jobs(opt.threads);
+        jobs.submit([this, &jobs, all] { expand(jobs, all, opt.attempts, {}); });
+        jobs.wait();
+        threadsUsed = jobs.threadCount();
+    }
+
+    void report() const {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Grade " << opt.cols << "x" << opt.rows << " (semente " << opt.seed
+                  << ", limiar " << opt.threshold << ", " << opt.attempts << " tentativas)\n"
+                  << "Melhor pontuacao: " << bestScore.load() << " de " << n
+                  << (timedOut.load() ? "  [melhor encontrada, tempo esgotado]" : "  [otima]") << "\n"
+                  << "Cliques (x,y com y a partir de baixo):";
+        for (int c : bestPath) std::cout << " (" << c % opt.cols << "," << c / opt.cols << ")";
+        std::cout << "\nNos: " << nodes.load() << "  Estados memorizados: " << memo.size()
+                  << "  Threads: " << threadsUsed << "  Tempo: " << secs << " s\n";
+    }
+
+private:
+    struct Move {
+        int  cell;
+        int  gain;
+        Bits removed;
+    };
+
+    static int popcount(const Bits& b) {
+        int c = 0;
+        for (uint64_t w : b) c += __builtin_popcountll(w);
+        return c;
+    }
+
+    // Movimentos distintos a partir de "alive", ordenados por ganho decrescente.
+    // Células com o mesmo conjunto removido viram um único movimento. Conjuntos contidos
+    // em outro não podem ser descartados: a similaridade não é transitiva, e remover mais
+    // agora pode partir um grupo que um clique menor depois removeria inteiro.
+    std::vector<Move> moves(const Bits& alive) const {
+        std::vector<Move> out;
+        std::unordered_map<Bits, int, BitsHash> seen;
+        for (int w = 0; w < words; ++w) {
+            for (uint64_t m = alive[w]; m; m &= m - 1) {
+                int c = w * 64 + __builtin_ctzll(m);
+                Bits r(words);
+                for (int k = 0; k < words; ++k) r[k] = similar[c][k] & alive[k];
+                if (seen.count(r)) continue;
+                seen.emplace(r, c);
+                out.push_back({ c, popcount(r), std::move(r) });
+            }
+        }
+        std::sort(out.begin(), out.end(), [](const Move& a, const Move& b) { return a.gain > b.gain; });
+        return out;
+    }
+
+    // Solução gulosa inicial: dá um limite inferior para a poda logo de início
+    void greedy(Bits alive) {
+        std::vector<int> path;
+        int score = 0;
+        for (int left = opt.attempts; left > 0; --left) {
+            auto ms = moves(alive);
+            if (ms.empty()) break;
+            const Move& m = ms.front();
+            for (int w = 0; w < words; ++w) alive[w] &= ~m.removed[w];
+            score += m.gain;
+            path.push_back(m.cell);
+        }
+        offer(score, path);
+    }
+
+    void offer(int score, const std::vector<int>& path) {
+        int cur = bestScore.load();
+        while (score > cur && !bestScore.compare_exchange_weak(cur, score)) {}
+        if (score <= cur) return;
+        std::lock_guard<std::mutex> lk(bestMutex);
+        if (score >= bestScore.load()) bestPath = path;
+    }
+
+    bool outOfTime() {
+        if (timedOut.load(std::memory_order_relaxed)) return true;
+        if ((nodes.load(std::memory_order_relaxed) & 255) != 0) return false;
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (secs > opt.timeLimit) timedOut = true;
+        return timedOut.load();
+    }
+
+    // Os dois primeiros níveis viram tarefas (para o roubo de trabalho ter o que
+    // dividir); abaixo disso a busca segue recursiva na mesma thread.
+    void expand(JobSystem& jobs, const Bits& alive, int left, std::vector<int> path) {
+        nodes.fetch_add(1, std::memory_order_relaxed);
+        if (outOfTime()) return;
+
+        int removed = n - popcount(alive);
+        offer(removed, path);
+        if (left == 0 || removed == n) return;
+        if (memo.visit(alive, left)) return;
+
+        // Limite superior: cada clique futuro remove um subconjunto do conjunto atual da
+        // célula clicada, e os removidos de cliques diferentes são disjuntos; então "left"
+        // cliques rendem no máximo a soma dos "left" maiores ganhos. A soma é sobre a lista
+        // completa de moves(): sem os conjuntos contidos em outros, um movimento de 5 que
+        // contém um de 4 daria 5 + o próximo ganho mantido para 2 cliques, e não 5 + 4.
+        auto ms = moves(alive);
+        std::vector<int> prefix(ms.size() + 1, 0);
+        for (size_t k = 0; k < ms.size(); ++k) prefix[k + 1] = prefix[k] + ms[k].gain;
+        auto top = [&](int count) { return prefix[std::min<size_t>(count, ms.size())]; };
+        if (std::min(removed + top(left), n) <= bestScore.load(std::memory_order_relaxed)) return;
+
+        bool spawn = (opt.attempts - left) < 2;
+        for (size_t k = 0; k < ms.size(); ++k) {
+            // limite do filho: este movimento + os (left-1) maiores ganhos entre os demais;
+            // não cresce com k, então o primeiro filho sem chance encerra o laço
+            int rest = (int)k < left - 1 ? removed + top(left)
+                                         : removed + ms[k].gain + top(left - 1);
+            if (std::min(rest, n) <= bestScore.load(std::memory_order_relaxed)) break;
+
+            Bits next(alive);
+            for (int w = 0; w < words; ++w) next[w] &= ~ms[k].removed[w];
+            std::vector<int> p(path);
+            p.push_back(ms[k].cell);
+            if (spawn) {
+                jobs.submit([this, &jobs, next = std::move(next), left, p = std::move(p)] {
+                    expand(jobs, next, left - 1, p);
+                });
+            } else {
+                expand(jobs, next, left - 1, std::move(p));
+            }
+        }
+    }
+
+    Options opt;
+    int     n, words;
+    std::vector<Bits>  similar;
+    TranspositionTable memo;
+
+    std::atomic<int>      bestScore{0};
+    std::mutex            bestMutex;
+    std::vector<int>      bestPath;
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<bool>     timedOut{false};
+    unsigned              threadsUsed = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << a << "\n";
+            return 1;
+        }
+        const char* v = argv[++i];
+        if      (a == "--cols")      opt.cols      = std::atoi(v);
+        else if (a == "--rows")      opt.rows      = std::atoi(v);
+        else if (a == "--seed")    { opt.seed      = (unsigned)std::strtoul(v, nullptr, 10); opt.hasSeed = true; }
+        else if (a == "--threshold") opt.threshold = (float)std::atof(v);
+        else if (a == "--attempts")  opt.attempts  = std::atoi(v);
+        else if (a == "--threads")   opt.threads   = (unsigned)std::atoi(v);
+        else if (a == "--time")      opt.timeLimit = std::atof(v);
+        else if (a == "--memo-mb")   opt.memoMB    = (size_t)std::atoll(v);
+        else {
+            std::cerr << "Opcao desconhecida: " << a << "\n";
+            return 1;
+        }
+    }
+    if (opt.cols <= 0 || opt.rows <= 0 || opt.attempts <= 0) {
+        std::cerr << "Dimensoes e tentativas devem ser positivas\n";
+        return 1;
+    }
+    if (!opt.hasSeed) opt.seed = std::random_device{}();
+
+    Solver solver(opt, generateColors(opt));
+    solver.run();
+    solver.report();
+    return 0;
+}
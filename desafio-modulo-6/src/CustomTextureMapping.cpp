@@ -9,6 +9,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "scene_graph.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -66,13 +68,14 @@ const char* vsSrc = R"glsl(
 layout(location=0) in vec2 aPos;
 layout(location=1) in vec2 aUV;
 uniform mat4 projection;
-uniform mat4 model;
+uniform vec3 model[2];   // linhas da afim 2x3
 uniform vec2 texScale;
 uniform vec2 texOffset;
 out vec2 UV;
 void main(){
     UV = aUV * texScale + texOffset;
-    gl_Position = projection * model * vec4(aPos,0,1);
+    vec3 p = vec3(aPos,1);
+    gl_Position = projection * vec4(dot(model[0],p), dot(model[1],p), 0, 1);
 }
 )glsl";
 
@@ -196,10 +199,13 @@ int main(){
     Sprite idle ( loadTexture("resources/Gangsters/Idle.png"),   1, 7, 0.12f );
     Sprite walk ( loadTexture("resources/Gangsters/Walk.png"),   1,10, 0.10f );
 
-    glm::vec2 bgPos   = { SCR_W * 0.5f, SCR_H * 0.5f };
-    glm::vec2 bgScale = { (float)SCR_W,  (float)SCR_H   };
-    glm::vec2 playerPos   = { 400.0f, 300.0f };
-    glm::vec2 playerScale = {  64.0f,  64.0f   };
+    // grafo de cena: o fundo é estático (calculado uma vez); o jogador é uma âncora
+    // só com posição, e o sprite (64×64) e o contorno são filhos que a seguem
+    SceneGraph scene;
+    const auto bgNode      = scene.add(SceneGraph::NONE, SCR_W * 0.5f, SCR_H * 0.5f, (float)SCR_W, (float)SCR_H);
+    const auto playerNode  = scene.add(SceneGraph::NONE, 400.0f, 300.0f);
+    const auto playerBody  = scene.add(playerNode, 0.0f, 0.0f, 64.0f, 64.0f);
+    const auto playerFrame = scene.add(playerNode, 0.0f, 0.0f, 64.0f, 64.0f);
     Sprite*   player      = &idle;
 
     glEnable(GL_BLEND);
@@ -222,14 +228,17 @@ int main(){
 
         if(up||down||left||right){
             player = &walk;
-            if(up)    playerPos.y += speed * dt;
-            if(down)  playerPos.y -= speed * dt;
-            if(left)  playerPos.x -= speed * dt;
-            if(right) playerPos.x += speed * dt;
+            float dx = 0, dy = 0;
+            if(up)    dy += speed * dt;
+            if(down)  dy -= speed * dt;
+            if(left)  dx -= speed * dt;
+            if(right) dx += speed * dt;
+            scene.translate(playerNode, dx, dy);
         } else {
             player = &idle;
         }
         player->Update(dt);
+        scene.update();
 
         glClearColor(0,0,0,1);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -237,18 +246,10 @@ int main(){
         glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
         glUniform1i(locOutline,0);
 
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(bgPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(bgScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          bg.Draw(shader);
-        }
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(playerPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(playerScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          player->Draw(shader);
-        }
+        glUniform3fv(locModel,2,scene.world(bgNode).rows());
+        bg.Draw(shader);
+        glUniform3fv(locModel,2,scene.world(playerBody).rows());
+        player->Draw(shader);
 
         glPolygonMode(GL_FRONT_AND_BACK,GL_LINE);
         glUniform1i(locOutline,1);
@@ -256,18 +257,10 @@ int main(){
         glLineWidth(2.0f);
         glBindVertexArray(outlineVAO);
 
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(bgPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(bgScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          glDrawArrays(GL_LINE_LOOP,0,4);
-        }
-        {
-          glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(playerPos,0.0f))
-                      * glm::scale   (glm::mat4(1.0f), glm::vec3(playerScale,1.0f));
-          glUniformMatrix4fv(locModel,1,GL_FALSE,glm::value_ptr(M));
-          glDrawArrays(GL_LINE_LOOP,0,4);
-        }
+        glUniform3fv(locModel,2,scene.world(bgNode).rows());
+        glDrawArrays(GL_LINE_LOOP,0,4);
+        glUniform3fv(locModel,2,scene.world(playerFrame).rows());
+        glDrawArrays(GL_LINE_LOOP,0,4);
 
         glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
         glUniform1i(locOutline,0);
@@ -0,0 +1,153 @@
+// EcsBench.cpp
+// Benchmark de iteração do ECS (include/ecs.h) com muitas entidades.
+// Cena sintética no estilo do tilemap: NPCs (posição, velocidade, animação) e itens
+// (posição, item). Mede:
+//   - sistema de movimento (Position+Velocity) e de animação (Animation) no ECS;
+//   - o mesmo trabalho sobre um vetor de structs "tudo em um" (como GameItem), em que
+//     cada iteração arrasta pela cache os campos que o sistema não usa;
+//   - criação/destruição em massa, conferindo que handles antigos ficam inválidos.
+//
+// Uso: EcsBench [--entities N] [--passes N]
+
+#include "ecs.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Position  { float x, y; };
+struct Velocity  { float x, y; };
+struct Animation { float acc, frameDur; int frame, frames; };
+struct Item      { uint32_t texture; int type; };
+
+// Referência AoS: uma struct com tudo que uma entidade do jogo poderia ter
+struct FatEntity {
+    int      gridX, gridY;
+    float    x, y, vx, vy;
+    float    acc, frameDur;
+    int      frame, frames;
+    uint32_t texture;
+    int      type;
+    bool     isItem, collected;
+    char     name[32];
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t entities = 1000000;
+    int    passes   = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << a << "\n";
+            return 1;
+        }
+        const char* v = argv[++i];
+        if      (a == "--entities") entities = (size_t)std::atoll(v);
+        else if (a == "--passes")   passes   = std::atoi(v);
+        else {
+            std::cerr << "Opcao desconhecida: " << a << "\n";
+            return 1;
+        }
+    }
+    if (entities == 0 || passes <= 0) {
+        std::cerr << "Entidades e passadas devem ser positivas\n";
+        return 1;
+    }
+
+    std::mt19937 rng{ 7 };
+    std::uniform_real_distribution<float> pos(0.0f, 1000.0f), vel(-1.0f, 1.0f);
+    const float dt = 1.0f / 60.0f;
+
+    // 80% NPCs, 20% itens
+    ecs::World world;
+    std::vector<FatEntity> fat(entities);
+    std::vector<ecs::Entity> handles;
+    handles.reserve(entities);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entities; ++i) {
+        FatEntity& f = fat[i];
+        f = FatEntity{};
+        f.x = pos(rng); f.y = pos(rng);
+        if (i % 5 != 4) {
+            f.vx = vel(rng); f.vy = vel(rng);
+            f.frameDur = 0.1f; f.frames = 7;
+            handles.push_back(world.create(Position{ f.x, f.y }, Velocity{ f.vx, f.vy },
+                                           Animation{ 0.0f, 0.1f, 0, 7 }));
+        } else {
+            f.isItem = true; f.type = (int)(i % 3);
+            handles.push_back(world.create(Position{ f.x, f.y }, Item{ 0u, f.type }));
+        }
+    }
+    double createMs = elapsedMs(t0);
+
+    // Sistemas no ECS
+    t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < passes; ++p) {
+        world.forEachChunk<Position, Velocity>([&](size_t n, ecs::Entity*, Position* ps, Velocity* vs) {
+            for (size_t i = 0; i < n; ++i) {
+                ps[i].x += vs[i].x * dt;
+                ps[i].y += vs[i].y * dt;
+            }
+        });
+        world.forEach<Animation>([&](Animation& a) {
+            a.acc += dt;
+            if (a.acc >= a.frameDur) { a.acc -= a.frameDur; a.frame = (a.frame + 1) % a.frames; }
+        });
+    }
+    double ecsMs = elapsedMs(t0) / passes;
+
+    // Mesmo trabalho sobre o vetor de structs
+    t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < passes; ++p) {
+        for (FatEntity& f : fat) {
+            if (f.isItem) continue;
+            f.x += f.vx * dt;
+            f.y += f.vy * dt;
+        }
+        for (FatEntity& f : fat) {
+            if (f.isItem) continue;
+            f.acc += dt;
+            if (f.acc >= f.frameDur) { f.acc -= f.frameDur; f.frame = (f.frame + 1) % f.frames; }
+        }
+    }
+    double aosMs = elapsedMs(t0) / passes;
+
+    // Confere que os dois caminhos chegaram ao mesmo estado
+    size_t mismatches = 0;
+    for (size_t i = 0; i < entities; ++i) {
+        const Position& p = world.get<Position>(handles[i]);
+        if (p.x != fat[i].x || p.y != fat[i].y) ++mismatches;
+    }
+
+    // Rotatividade: destrói metade e recria; os handles antigos devem morrer
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entities; i += 2) world.destroy(handles[i]);
+    size_t stale = 0;
+    for (size_t i = 0; i < entities; i += 2) {
+        ecs::Entity e = world.create(Position{ 0.0f, 0.0f }, Velocity{ 0.0f, 0.0f },
+                                     Animation{ 0.0f, 0.1f, 0, 7 });
+        if (world.alive(handles[i])) ++stale;
+        (void)e;
+    }
+    double churnMs = elapsedMs(t0);
+
+    double ns = 1e6 / (double)entities;
+    std::cout << "Entidades: " << entities << "  Arquetipos: " << world.archetypeCount()
+              << "  Passadas: " << passes << "\n"
+              << "Criacao: " << createMs << " ms\n"
+              << "ECS (SoA por arquetipo): " << ecsMs << " ms/passada, " << ecsMs * ns << " ns/entidade\n"
+              << "Vetor de structs       : " << aosMs << " ms/passada, " << aosMs * ns << " ns/entidade ("
+              << sizeof(FatEntity) << " bytes por entidade)\n"
+              << "Aceleracao: " << aosMs / ecsMs << "x  Divergencias: " << mismatches << "\n"
+              << "Destruir/recriar metade: " << churnMs << " ms  Handles antigos ainda vivos: "
+              << stale << "\n";
+    return (mismatches || stale) ? 1 : 0;
+}
@@ -2,13 +2,23 @@
 // PARTE 2 - Exercício 3: Instanciação dinâmica de triângulos com matriz de transformação
 // Utiliza um único VAO para um triângulo padrão e cria novos triângulos via clique do mouse,
 // com cores aleatórias.
+// Os triângulos são desenhados com uma única chamada instanciada: posição e cor de cada um
+// ficam em um buffer por instância, que recebe só a instância nova a cada clique.
+// Botão direito seleciona o triângulo sob o cursor (o de cima); um segundo clique direito no
+// triângulo selecionado o remove. A busca usa uma grade uniforme de células.
+// Teste de carga: Ex1Parte2 --spawn N cria N triângulos aleatórios na inicialização.
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <ctime>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "gl_resources.h"
 
 // GLM para transformações
 #include <glm/glm.hpp>
@@ -28,64 +38,225 @@ struct Triangle {
     glm::vec3 color;     // Cor (RGB)
 };
 
-// Vetor global para armazenar os triângulos criados
+// Vetor global para armazenar os triângulos criados (espelho do buffer de instâncias)
 vector<Triangle> triangleInstances;
 
-// Identificador do VAO único para o triângulo padrão
-GLuint defaultTriangleVAO = 0;
+// Escala aplicada ao triângulo padrão (antes era a matriz de modelo por triângulo)
+const float TRIANGLE_SCALE = 300.0f;
+
+// VAO único para o triângulo padrão + buffers de vértices e de instâncias
+gl::VertexArray defaultTriangleVAO;
+gl::Buffer      triangleVBO;
+gl::Buffer      instanceVBO;
+size_t          instanceCapacity = 0;   // em instâncias
+
+// Triângulo selecionado com o botão direito (-1 = nenhum)
+int selectedTriangle = -1;
 
 // Janela global (para usar no callback)
 GLFWwindow* window = nullptr;
 
+// Vértices do triângulo padrão; z = 0.
+const GLfloat defaultTriangleVertices[] = {
+    -0.1f, -0.1f, 0.0f,
+     0.1f, -0.1f, 0.0f,
+     0.0f,  0.1f, 0.0f
+};
+
+// Aponta os atributos por instância (1 = posição, 2 = cor) para o instanceVBO atual
+void setupInstanceAttributes()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Triangle), (GLvoid*)offsetof(Triangle, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Triangle), (GLvoid*)offsetof(Triangle, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+}
+
 // Função que cria o VAO para o triângulo padrão
 // Vértices: v0 = (-0.1, -0.1), v1 = (0.1, -0.1), v2 = (0.0, 0.1)
-GLuint createDefaultTriangle()
+void createDefaultTriangle()
 {
-    // Define os vértices do triângulo padrão; z = 0.
-    GLfloat vertices[] = {
-        -0.1f, -0.1f, 0.0f,
-         0.1f, -0.1f, 0.0f,
-         0.0f,  0.1f, 0.0f
-    };
-    
-    GLuint VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    
-    glBindVertexArray(VAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    
+    defaultTriangleVAO = gl::VertexArray::create();
+    triangleVBO        = gl::Buffer::create();
+    instanceVBO        = gl::Buffer::create();
+
+    glBindVertexArray(defaultTriangleVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(defaultTriangleVertices), defaultTriangleVertices, GL_STATIC_DRAW);
+
     // O shader espera que o atributo "position" esteja na localização 0.
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
     glEnableVertexAttribArray(0);
-    
+
+    instanceCapacity = 1024;
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Triangle), nullptr, GL_DYNAMIC_DRAW);
+    setupInstanceAttributes();
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-    
-    return VAO;
+}
+
+// Envia a instância "i" (já presente em triangleInstances) para a GPU.
+// Ao faltar espaço, o buffer dobra e recebe o espelho inteiro de uma vez.
+void uploadInstance(size_t i)
+{
+    if (triangleInstances.size() > instanceCapacity) {
+        while (instanceCapacity < triangleInstances.size()) instanceCapacity *= 2;
+        instanceVBO = gl::Buffer::create();
+        glBindVertexArray(defaultTriangleVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Triangle), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, triangleInstances.size() * sizeof(Triangle), triangleInstances.data());
+        setupInstanceAttributes();
+        glBindVertexArray(0);
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, i * sizeof(Triangle), sizeof(Triangle), &triangleInstances[i]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// ------------------------------------------------------------------
+// Índice de picking: grade uniforme sobre a janela. Cada triângulo entra só
+// na célula do seu centro; a consulta olha as células vizinhas até o raio
+// máximo do triângulo, então a cela precisa ser >= esse raio.
+// ------------------------------------------------------------------
+const float TRIANGLE_RADIUS = 0.1f * TRIANGLE_SCALE;  // meia-largura do triângulo escalado
+const float PICK_CELL       = 32.0f;
+const int   PICK_COLS       = int(WIDTH  / PICK_CELL) + 1;
+const int   PICK_ROWS       = int(HEIGHT / PICK_CELL) + 1;
+
+vector<vector<int>> pickCells(PICK_COLS * PICK_ROWS);
+vector<int>         cellOfTriangle;   // célula de cada triângulo
+vector<int>         slotInCell;       // posição do triângulo dentro de pickCells[célula]
+
+int pickCellAt(float x, float y)
+{
+    int cx = std::min(std::max(int(x / PICK_CELL), 0), PICK_COLS - 1);
+    int cy = std::min(std::max(int(y / PICK_CELL), 0), PICK_ROWS - 1);
+    return cy * PICK_COLS + cx;
+}
+
+void pickInsert(int id)
+{
+    int c = pickCellAt(triangleInstances[id].position.x, triangleInstances[id].position.y);
+    cellOfTriangle.push_back(c);
+    slotInCell.push_back((int)pickCells[c].size());
+    pickCells[c].push_back(id);
+}
+
+// Tira "id" da sua célula em O(1) (troca com o último da célula)
+void pickErase(int id)
+{
+    vector<int>& cell = pickCells[cellOfTriangle[id]];
+    int slot = slotInCell[id];
+    int moved = cell.back();
+    cell[slot] = moved;
+    slotInCell[moved] = slot;
+    cell.pop_back();
+}
+
+// Renomeia o triângulo "from" para "to" dentro do índice
+void pickRename(int from, int to)
+{
+    cellOfTriangle[to] = cellOfTriangle[from];
+    slotInCell[to]     = slotInCell[from];
+    pickCells[cellOfTriangle[to]][slotInCell[to]] = to;
+}
+
+// Teste ponto-no-triângulo no espaço do triângulo padrão
+bool pointInTriangle(const Triangle& tri, float x, float y)
+{
+    float px = (x - tri.position.x) / TRIANGLE_SCALE;
+    float py = (y - tri.position.y) / TRIANGLE_SCALE;
+    const GLfloat* v = defaultTriangleVertices;
+    auto edge = [](float ax, float ay, float bx, float by, float cx, float cy) {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    };
+    float e0 = edge(v[0], v[1], v[3], v[4], px, py);
+    float e1 = edge(v[3], v[4], v[6], v[7], px, py);
+    float e2 = edge(v[6], v[7], v[0], v[1], px, py);
+    return (e0 >= 0 && e1 >= 0 && e2 >= 0) || (e0 <= 0 && e1 <= 0 && e2 <= 0);
+}
+
+// Triângulo visível sob o ponto: o de maior índice (desenhado por último), ou -1
+int pickTriangle(float x, float y)
+{
+    int best = -1;
+    int x0 = int((x - TRIANGLE_RADIUS) / PICK_CELL), x1 = int((x + TRIANGLE_RADIUS) / PICK_CELL);
+    int y0 = int((y - TRIANGLE_RADIUS) / PICK_CELL), y1 = int((y + TRIANGLE_RADIUS) / PICK_CELL);
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+    x1 = std::min(x1, PICK_COLS - 1); y1 = std::min(y1, PICK_ROWS - 1);
+    for (int cy = y0; cy <= y1; ++cy)
+        for (int cx = x0; cx <= x1; ++cx)
+            for (int id : pickCells[cy * PICK_COLS + cx])
+                if (id > best && pointInTriangle(triangleInstances[id], x, y))
+                    best = id;
+    return best;
+}
+
+void spawnTriangle(float x, float y)
+{
+    Triangle tri;
+    tri.position = glm::vec2(x, y);
+    float r = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    float g = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    float b = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    tri.color = glm::vec3(r, g, b);
+
+    triangleInstances.push_back(tri);
+    int id = (int)triangleInstances.size() - 1;
+    pickInsert(id);
+    uploadInstance(id);
+}
+
+// Remove trocando com o último: só uma instância é reenviada
+void deleteTriangle(int id)
+{
+    int last = (int)triangleInstances.size() - 1;
+    pickErase(id);
+    if (id != last) {
+        triangleInstances[id] = triangleInstances[last];
+        pickRename(last, id);
+        uploadInstance(id);
+    }
+    triangleInstances.pop_back();
+    cellOfTriangle.pop_back();
+    slotInCell.pop_back();
+    if (selectedTriangle == id)        selectedTriangle = -1;
+    else if (selectedTriangle == last) selectedTriangle = id;
 }
 
 // Shaders (GLSL 330 core para OpenGL 3.3+)
+// Atributos 1 e 2 são por instância; o selecionado é desenhado em branco.
 const char* vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 instPosition;
+layout (location = 2) in vec3 instColor;
 uniform mat4 projection;
-uniform mat4 model;
+uniform float scale;
+uniform int selected;
+out vec4 vColor;
 void main()
 {
-    gl_Position = projection * model * vec4(position, 1.0);
+    vColor = (gl_InstanceID == selected) ? vec4(1.0) : vec4(instColor, 1.0);
+    gl_Position = projection * vec4(instPosition + position.xy * scale, position.z, 1.0);
 }
 )";
 
 const char* fragmentShaderSource = R"(
 #version 330 core
+in vec4 vColor;
 out vec4 fragColor;
-uniform vec4 inputColor;
 void main()
 {
-    fragColor = inputColor;
+    fragColor = vColor;
 }
 )";
 
@@ -132,32 +303,43 @@ GLuint setupShaderProgram()
     return shaderProgram;
 }
 
-// Callback do mouse: cria um novo triângulo na posição do clique com cor aleatória.
+// Callback do mouse: esquerdo cria um novo triângulo na posição do clique com cor aleatória;
+// direito seleciona o triângulo sob o cursor ou, se já estiver selecionado, o remove.
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
-    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    if (action != GLFW_PRESS) return;
+
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+
+    // Converte as coordenadas de clique:
+    int winWidth, winHeight;
+    glfwGetWindowSize(window, &winWidth, &winHeight);
+    ypos = winHeight - ypos; // Inverte o y, pois GLFW entrega com origem no topo
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT)
     {
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        
-        // Converte as coordenadas de clique:
-        int winWidth, winHeight;
-        glfwGetWindowSize(window, &winWidth, &winHeight);
-        ypos = winHeight - ypos; // Inverte o y, pois GLFW entrega com origem no topo
-        
-        // Cria uma instância de Triangle com posição e cor aleatória
-        Triangle tri;
-        tri.position = glm::vec2(xpos, ypos);
-        float r = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-        float g = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-        float b = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-        tri.color = glm::vec3(r, g, b);
-        
-        triangleInstances.push_back(tri);
-        
+        spawnTriangle((float)xpos, (float)ypos);
+
         // (Opcional) Imprime as coordenadas para depuração
         cout << "Clique em: " << xpos << ", " << ypos << endl;
     }
+    else if (button == GLFW_MOUSE_BUTTON_RIGHT)
+    {
+        auto t0 = chrono::steady_clock::now();
+        int hit = pickTriangle((float)xpos, (float)ypos);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+
+        if (hit < 0) {
+            selectedTriangle = -1;
+        } else if (hit == selectedTriangle) {
+            deleteTriangle(hit);
+            cout << "Triangulo " << hit << " removido (" << triangleInstances.size() << " restantes)" << endl;
+        } else {
+            selectedTriangle = hit;
+            cout << "Triangulo " << hit << " selecionado (busca: " << us << " us)" << endl;
+        }
+    }
 }
 
 // Callback de teclado: fecha a janela ao pressionar ESC.
@@ -167,8 +349,12 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         glfwSetWindowShouldClose(window, true);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    long spawnCount = 0;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (string(argv[i]) == "--spawn") spawnCount = atol(argv[i + 1]);
+
     // Inicializa GLFW
     if (!glfwInit()) {
         cout << "Falha ao inicializar GLFW" << endl;
@@ -204,16 +390,27 @@ int main()
     GLuint shaderProgram = setupShaderProgram();
     
     // Cria o VAO único para o triângulo padrão
-    defaultTriangleVAO = createDefaultTriangle();
+    createDefaultTriangle();
     
     // Configura a projeção ortográfica: (0,0) no canto inferior esquerdo e (WIDTH, HEIGHT) no canto superior direito
     glm::mat4 projection = glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT, -1.0f, 1.0f);
     glUseProgram(shaderProgram);
     GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
     glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    
+    glUniform1f(glGetUniformLocation(shaderProgram, "scale"), TRIANGLE_SCALE);
+    GLint selectedLoc = glGetUniformLocation(shaderProgram, "selected");
+
     // Define a semente para geração de cores aleatórias
     srand(static_cast<unsigned int>(time(nullptr)));
+
+    // Triângulos sintéticos para teste de carga
+    if (spawnCount > 0) {
+        triangleInstances.reserve(spawnCount);
+        for (long i = 0; i < spawnCount; ++i)
+            spawnTriangle(WIDTH  * (rand() / (float)RAND_MAX),
+                          HEIGHT * (rand() / (float)RAND_MAX));
+        cout << spawnCount << " triangulos criados" << endl;
+    }
     
     // Loop de renderização
     while (!glfwWindowShouldClose(window))
@@ -225,30 +422,17 @@ int main()
         
         glUseProgram(shaderProgram);
         
-        // Para cada triângulo instanciado via mouse, aplica a transformação e desenha
-        for (const Triangle& tri : triangleInstances)
-        {
-            // Constrói a matriz de modelo: traduza o triângulo padrão para a posição desejada
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(tri.position, 0.0f));
-
-            model = glm::scale(model, glm::vec3(300.0f, 300.0f, 1.0f));
-            
-            GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            
-            GLint colorLoc = glGetUniformLocation(shaderProgram, "inputColor");
-            glUniform4f(colorLoc, tri.color.r, tri.color.g, tri.color.b, 1.0f);
-            
-            // Desenha o triângulo padrão usando o VAO único
-            glBindVertexArray(defaultTriangleVAO);
-            glDrawArrays(GL_TRIANGLES, 0, 3);
-        }
+        // Todos os triângulos em uma chamada: o VAO único + atributos por instância
+        glUniform1i(selectedLoc, selectedTriangle);
+        glBindVertexArray(defaultTriangleVAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 3, (GLsizei)triangleInstances.size());
         glBindVertexArray(0);
-        
+
         glfwSwapBuffers(window);
+        gl::collectGarbage();
     }
-    
+
+    gl::shutdown();
     glfwTerminate();
     return 0;
 }
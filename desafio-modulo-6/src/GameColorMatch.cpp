@@ -2,9 +2,31 @@
 // Jogo de “Color Match”: o usuário clica em um retângulo para escolher sua cor,
 // e todos os retângulos cuja cor seja similar (distância Euclidiana em RGB ≤ limiar)
 // são removidos. Cada clique conta como uma tentativa; pontos = número de retângulos removidos.
+// A grade inteira é desenhada com uma única chamada instanciada: posição e cor de cada
+// retângulo vão para buffers por instância enviados uma vez, e a máscara de vivos só é
+// reenviada (no trecho alterado) quando um clique remove retângulos.
+// Tecla M alterna para o modo "região": remove só a região conectada (4-vizinhança,
+// vizinhos com cor dentro do limiar) que contém o retângulo clicado.
+// Pontos, tentativas e modo aparecem na própria janela (include/bitmap_text.h); o
+// layout do texto só é refeito quando um deles muda.
+// Listas temporárias do clique ficam na arena do frame (include/frame_arena.h), e o
+// desenho do frame não aloca; o total de alocações sai no resumo final.
+// Por padrão o laço só desenha quando um clique ou tecla muda algo (include/frame_pacer.h):
+// GameColorMatch [semente] [--cols N] [--rows N] [--pacing ondemand|cap|vsync|off] [--fps N]
+// Grades a partir de 64k retângulos (ex.: --cols 400 --rows 300) rotulam as regiões em
+// paralelo, por faixas de linhas.
+// Com --capture <destino> os frames são gravados (include/frame_capture.h); com a mesma
+// semente as imagens se repetem, e servem de referência para o ImageDiff.
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#define ALLOC_STATS_IMPLEMENTATION   // conta as alocações do executável
+#include "alloc_stats.h"
+#include "bitmap_text.h"
+#include "logger.h"
+#include "frame_arena.h"
+#include "frame_pacer.h"
+#include "frame_capture.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -13,14 +35,22 @@
 #include <vector>
 #include <random>
 #include <iostream>
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <string>
 
 // --- Configurações da janela e da grade ---
 const int WINDOW_W = 800;
 const int WINDOW_H = 600;
-const int COLS     = 8;
-const int ROWS     = 6;
-const float RECT_W = WINDOW_W  / float(COLS);
-const float RECT_H = WINDOW_H / float(ROWS);
+// Tamanho da grade (--cols/--rows, como no ColorMatchSolver); no máximo um retângulo por pixel
+int   cols  = 8;
+int   rows  = 6;
+float rectW = WINDOW_W / float(cols);
+float rectH = WINDOW_H / float(rows);
 
 // --- Parâmetros do jogo ---
 const int   MAX_ATTEMPTS    = 10;
@@ -29,54 +59,239 @@ const float COLOR_THRESHOLD = 0.25f; // Distância máxima em RGB para considera
 struct Rect {
     glm::vec2 pos;
     glm::vec3 color;
-    bool      alive = true;
 };
 
-std::vector<Rect> grid;
+std::vector<Rect>    grid;
+std::vector<GLubyte> aliveMask;   // 1 = vivo, 0 = removido (espelhado no buffer de instâncias)
+int aliveCount = 0;               // mantido a cada remoção, evita varrer a grade por frame
 int score    = 0;
 int attempts = 0;
+bool hudDirty = true;   // pontos/tentativas/modo mudaram: refaz o layout do placar
 
-// Gera cores aleatórias e inicializa a grade
-void initGrid() {
-    std::mt19937 rng{ std::random_device{}() };
+// Temporários do frame (callbacks incluídos); zerada no começo de cada frame
+FrameArena frameArena(64 * 1024);
+FramePacer pacer;   // callbacks pedem um novo frame
+
+// Modo de remoção: todas as cores similares (original) ou apenas a região conectada
+enum class RemovalMode { Global, Region };
+RemovalMode removalMode = RemovalMode::Global;
+
+// Regiões conectadas, pré-calculadas por union-find (ver buildRegions)
+std::vector<int>              regionOf;   // rótulo da região de cada célula
+std::vector<std::vector<int>> regions;    // células de cada região, em ordem crescente
+
+// Buffers por instância (ver createQuadVAO)
+GLuint instanceVBO = 0;   // vec2 pos + vec3 cor, intercalados; enviado uma vez por grade
+GLuint aliveVBO    = 0;   // um byte por retângulo; atualizado só no trecho alterado
+
+// Gera cores aleatórias e inicializa a grade.
+// A mesma semente reproduz a grade analisada pelo ColorMatchSolver.
+void initGrid(unsigned seed) {
+    std::mt19937 rng{ seed };
     std::uniform_real_distribution<float> dist(0.0f,1.0f);
 
     grid.clear();
-    for(int y=0; y<ROWS; ++y) {
-        for(int x=0; x<COLS; ++x) {
+    grid.reserve(cols*rows);
+    for(int y=0; y<rows; ++y) {
+        for(int x=0; x<cols; ++x) {
             Rect r;
-            r.pos   = { x*RECT_W, y*RECT_H };
+            r.pos   = { x*rectW, y*rectH };
             r.color = { dist(rng), dist(rng), dist(rng) };
-            r.alive = true;
             grid.push_back(r);
         }
     }
+    aliveMask.assign(grid.size(), 1);
+    aliveCount = (int)grid.size();
     score = 0;
     attempts = 0;
 }
 
+// Envia posição/cor de todas as instâncias e a máscara de vivos completa.
+// Chamado apenas quando a grade é (re)gerada.
+void uploadGrid() {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, grid.size()*sizeof(Rect), grid.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, aliveVBO);
+    glBufferData(GL_ARRAY_BUFFER, aliveMask.size(), aliveMask.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Reenvia somente o intervalo [first, last] da máscara de vivos.
+void uploadAliveRange(int first, int last) {
+    if (first > last) return;
+    glBindBuffer(GL_ARRAY_BUFFER, aliveVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, first, last - first + 1, aliveMask.data() + first);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 // Distância Euclidiana entre cores
 float colorDistance(const glm::vec3& a, const glm::vec3& b) {
     return glm::length(a - b);
 }
 
+// ===========================================
+// Rotulação de componentes conectados
+// ===========================================
+// Duas células vizinhas (4-vizinhança) estão na mesma região se ambas estão vivas
+// e a distância entre suas cores é <= COLOR_THRESHOLD.
+bool sameRegion(int a, int b) {
+    return aliveMask[a] && aliveMask[b] &&
+           colorDistance(grid[a].color, grid[b].color) <= COLOR_THRESHOLD;
+}
+
+// Union-find com path halving; a raiz é sempre o menor índice do conjunto,
+// o que mantém cada faixa de linhas fechada em si mesma durante a fase paralela.
+int findRoot(int* parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void unite(int* parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a;
+    else       parent[a] = b;
+}
+
+// Une as células das linhas [y0, y1). Só toca índices dessas linhas.
+void labelRows(int* parent, int y0, int y1) {
+    for (int y = y0; y < y1; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            int i = y * cols + x;
+            if (x + 1 < cols && sameRegion(i, i + 1))      unite(parent, i, i + 1);
+            if (y + 1 < y1   && sameRegion(i, i + cols))   unite(parent, i, i + cols);
+        }
+    }
+}
+
+// Rotula a grade inteira: cada thread processa uma faixa de linhas e depois as
+// fronteiras entre faixas são costuradas em série. Custo O(N), feito uma vez por grade.
+// Devolve o número de faixas usadas.
+int buildRegions() {
+    const int n = (int)grid.size();
+    std::vector<int> parent(n);
+    for (int i = 0; i < n; ++i) parent[i] = i;
+
+    // Grades pequenas não compensam o custo de criar threads
+    int nStrips = 1;
+    if (n >= 64 * 1024) {
+        nStrips = std::max(1u, std::thread::hardware_concurrency());
+        nStrips = std::min(nStrips, rows);
+    }
+    std::vector<int> bounds(nStrips + 1);
+    for (int s = 0; s <= nStrips; ++s) bounds[s] = rows * s / nStrips;
+
+    if (nStrips == 1) {
+        labelRows(parent.data(), 0, rows);
+    } else {
+        std::vector<std::thread> workers;
+        for (int s = 0; s < nStrips; ++s)
+            workers.emplace_back(labelRows, parent.data(), bounds[s], bounds[s + 1]);
+        for (auto& t : workers) t.join();
+
+        for (int s = 1; s < nStrips; ++s) {
+            int y = bounds[s];
+            for (int x = 0; x < cols; ++x) {
+                int i = y * cols + x;
+                if (sameRegion(i - cols, i)) unite(parent.data(), i - cols, i);
+            }
+        }
+    }
+
+    // Converte raízes em rótulos compactos e agrupa as células por região
+    regionOf.assign(n, -1);
+    regions.clear();
+    std::vector<int> labelOfRoot(n, -1);
+    for (int i = 0; i < n; ++i) {
+        if (!aliveMask[i]) continue;
+        int r = findRoot(parent.data(), i);
+        if (labelOfRoot[r] < 0) {
+            labelOfRoot[r] = (int)regions.size();
+            regions.emplace_back();
+        }
+        regionOf[i] = labelOfRoot[r];
+        regions[regionOf[i]].push_back(i);
+    }
+    return nStrips;
+}
+
+// Recalcula uma região depois que parte de suas células foi removida (modo global).
+// Só visita as células da própria região; se ela se partir, a primeira parte mantém
+// o rótulo e as demais recebem rótulos novos.
+void relabelRegion(int label) {
+    ArenaVector<int> cells(frameArena);
+    for (int i : regions[label]) {
+        if (aliveMask[i]) cells.push_back(i);
+        else              regionOf[i] = -1;
+    }
+    regions[label].clear();
+    if (cells.empty()) return;
+
+    // union-find local indexado pela posição em "cells"
+    ArenaVector<int> parent(cells.size(), 0, frameArena);
+    for (int k = 0; k < (int)cells.size(); ++k) parent[k] = k;
+    auto localIndex = [&](int cell) {
+        auto it = std::lower_bound(cells.begin(), cells.end(), cell);
+        return (it != cells.end() && *it == cell) ? int(it - cells.begin()) : -1;
+    };
+    for (int k = 0; k < (int)cells.size(); ++k) {
+        int i = cells[k], x = i % cols;
+        if (x + 1 < cols && sameRegion(i, i + 1)) {
+            int j = localIndex(i + 1);
+            if (j >= 0) unite(parent.data(), k, j);
+        }
+        if (i + cols < (int)grid.size() && sameRegion(i, i + cols)) {
+            int j = localIndex(i + cols);
+            if (j >= 0) unite(parent.data(), k, j);
+        }
+    }
+
+    ArenaVector<int> labelOfRoot(cells.size(), -1, frameArena);
+    for (int k = 0; k < (int)cells.size(); ++k) {
+        int r = findRoot(parent.data(), k);
+        if (labelOfRoot[r] < 0) {
+            if (regions[label].empty()) labelOfRoot[r] = label;
+            else {
+                labelOfRoot[r] = (int)regions.size();
+                regions.emplace_back();
+            }
+        }
+        regionOf[cells[k]] = labelOfRoot[r];
+        regions[labelOfRoot[r]].push_back(cells[k]);
+    }
+}
+
 // Shaders GLSL 330 core
+// Atributos 1..3 são por instância; retângulos removidos colapsam para fora do clip space.
 const char* vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 instPos;
+layout (location = 2) in vec3 instColor;
+layout (location = 3) in float instAlive;
 uniform mat4 projection;
-uniform mat4 model;
+uniform vec2 rectSize;
+out vec3 vColor;
 void main() {
-    gl_Position = projection * model * vec4(position, 1.0);
+    vColor = instColor;
+    if (instAlive < 0.5) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    gl_Position = projection * vec4(instPos + position.xy * rectSize, position.z, 1.0);
 }
 )";
 
 const char* fragmentShaderSource = R"(
 #version 330 core
+in vec3 vColor;
 out vec4 fragColor;
-uniform vec4 inputColor;
 void main() {
-    fragColor = inputColor;
+    fragColor = vec4(vColor, 1.0);
 }
 )";
 
@@ -122,6 +337,7 @@ GLuint setupShaderProgram() {
 }
 
 // Cria um VAO com um quad (2 triângulos) de tamanho unitário [0,1]x[0,1]
+// e os atributos por instância (pos, cor, vivo) apontando para instanceVBO/aliveVBO.
 GLuint createQuadVAO() {
     GLfloat verts[] = {
         // first triangle
@@ -142,6 +358,21 @@ GLuint createQuadVAO() {
       glBufferData(GL_ARRAY_BUFFER,sizeof(verts),verts,GL_STATIC_DRAW);
       glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(GLfloat),(void*)0);
       glEnableVertexAttribArray(0);
+
+      glGenBuffers(1,&instanceVBO);
+      glBindBuffer(GL_ARRAY_BUFFER,instanceVBO);
+      glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,sizeof(Rect),(void*)offsetof(Rect,pos));
+      glEnableVertexAttribArray(1);
+      glVertexAttribDivisor(1,1);
+      glVertexAttribPointer(2,3,GL_FLOAT,GL_FALSE,sizeof(Rect),(void*)offsetof(Rect,color));
+      glEnableVertexAttribArray(2);
+      glVertexAttribDivisor(2,1);
+
+      glGenBuffers(1,&aliveVBO);
+      glBindBuffer(GL_ARRAY_BUFFER,aliveVBO);
+      glVertexAttribPointer(3,1,GL_UNSIGNED_BYTE,GL_FALSE,sizeof(GLubyte),(void*)0);
+      glEnableVertexAttribArray(3);
+      glVertexAttribDivisor(3,1);
     glBindVertexArray(0);
 
     return VAO;
@@ -149,67 +380,146 @@ GLuint createQuadVAO() {
 
 // Callback de mouse: clica em um retângulo da grade para escolher sua cor
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    pacer.requestRedraw();
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS && attempts < MAX_ATTEMPTS) {
         double mx, my;
         glfwGetCursorPos(window, &mx, &my);
         my = WINDOW_H - my;
 
-        int cx = int(mx / RECT_W);
-        int cy = int(my / RECT_H);
-        if (cx < 0 || cx >= COLS || cy < 0 || cy >= ROWS) return;
+        int cx = int(mx / rectW);
+        int cy = int(my / rectH);
+        if (cx < 0 || cx >= cols || cy < 0 || cy >= rows) return;
 
-        int idx = cy * COLS + cx;
-        if (!grid[idx].alive) return;
+        int idx = cy * cols + cx;
+        if (!aliveMask[idx]) return;
 
         glm::vec3 chosen = grid[idx].color;
-        std::vector<std::pair<int, float>> removedInfo;
-
-        // verifica cada retângulo
-        for (int i = 0; i < (int)grid.size(); ++i) {
-            auto& r = grid[i];
-            if (!r.alive) continue;
-            float d = colorDistance(r.color, chosen);
-            if (d <= COLOR_THRESHOLD) {
-                r.alive = false;
-                removedInfo.emplace_back(i, d);
+        ArenaVector<std::pair<int, float>> removedInfo(frameArena);
+
+        if (removalMode == RemovalMode::Region) {
+            // remove apenas a região do clique; as demais regiões não mudam, pois
+            // nenhuma aresta as ligava a ela
+            int label = regionOf[idx];
+            for (int i : regions[label]) {
+                aliveMask[i] = 0;
+                regionOf[i]  = -1;
+                removedInfo.emplace_back(i, colorDistance(grid[i].color, chosen));
+            }
+            regions[label].clear();
+        } else {
+            // verifica cada retângulo
+            ArenaVector<int> touched(frameArena);
+            for (int i = 0; i < (int)grid.size(); ++i) {
+                if (!aliveMask[i]) continue;
+                float d = colorDistance(grid[i].color, chosen);
+                if (d <= COLOR_THRESHOLD) {
+                    aliveMask[i] = 0;
+                    removedInfo.emplace_back(i, d);
+                    touched.push_back(regionOf[i]);
+                }
             }
+            // as regiões que perderam células podem ter se partido
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            for (int label : touched) relabelRegion(label);
         }
 
         int removedCount = removedInfo.size();
-        score    += removedCount;
-        attempts += 1;
+        score      += removedCount;
+        attempts   += 1;
+        aliveCount -= removedCount;
+
+        // envia só o trecho alterado da máscara de vivos
+        if (removedCount > 0) {
+            auto byIndex = [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+                return a.first < b.first;
+            };
+            auto mm = std::minmax_element(removedInfo.begin(), removedInfo.end(), byIndex);
+            uploadAliveRange(mm.first->first, mm.second->first);
+        }
 
-        // LOG detalhado
-        std::cout << "Clique #" << attempts
-                  << ": removidos " << removedCount
-                  << " retângulos (limiar=" << COLOR_THRESHOLD << ")\n";
+        // LOG detalhado (assíncrono; o detalhe por retângulo é nível debug e limitado por segundo)
+        LOG_INFO("Clique #%d: removidos %d retangulos (limiar=%g)", attempts, removedCount, COLOR_THRESHOLD);
         for (auto& pr : removedInfo) {
             int   i = pr.first;
             float d = pr.second;
             auto& r = grid[i];
-            std::cout << "  - índice " << i
-                      << " em pos(" << r.pos.x << "," << r.pos.y << ")"
-                      << " cor(" << r.color.r << "," << r.color.g << "," << r.color.b << ")"
-                      << " dist=" << d
-                      << "\n";
+            LOG_DEBUG("  - indice %d em pos(%g,%g) cor(%g,%g,%g) dist=%g",
+                      i, r.pos.x, r.pos.y, r.color.r, r.color.g, r.color.b, d);
         }
 
-        // atualiza título da janela de forma segura
-        char title[128];
-        std::snprintf(title, sizeof(title),
-                      "Color Match - Score: %d   Attempts: %d/%d",
-                      score, attempts, MAX_ATTEMPTS);
-        glfwSetWindowTitle(window, title);
+        hudDirty = true;
     }
 }
 
-// Callback de teclado: ESC para sair
+// Callback de teclado: ESC para sair, M alterna o modo de remoção
 void key_callback(GLFWwindow* window,int key,int scancode,int action,int mods) {
+    pacer.requestRedraw();
     if(key==GLFW_KEY_ESCAPE && action==GLFW_PRESS)
         glfwSetWindowShouldClose(window,true);
+    if(key==GLFW_KEY_M && action==GLFW_PRESS){
+        removalMode = (removalMode == RemovalMode::Global) ? RemovalMode::Region
+                                                           : RemovalMode::Global;
+        LOG_INFO("Modo de remocao: %s",
+                 removalMode == RemovalMode::Region ? "regiao conectada" : "cores similares");
+        hudDirty = true;
+    }
 }
 
-int main(){
+int main(int argc, char** argv){
+    // 0) Argumentos: semente opcional e opções
+    // GameColorMatch [semente] [--cols N] [--rows N] [--pacing modo] [--fps N]
+    //   [--capture destino] [--capture-format png|ppm|raw] [--capture-frames N]
+    unsigned seed = std::random_device{}();
+    FramePacer::Mode pacing = FramePacer::Mode::OnDemand;
+    double targetFps = 60.0;
+    std::string captureDest;
+    FrameCapture::Format captureFormat = FrameCapture::Format::Png;
+    unsigned long long captureFrames = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            // só um número solto é a semente
+            char* end = nullptr;
+            unsigned long v = std::strtoul(argv[i], &end, 10);
+            if (arg.empty() || *end != '\0' || arg[0] == '-') {
+                std::cerr << "Argumento desconhecido: " << arg << " (a semente deve ser um numero)\n";
+                return -1;
+            }
+            seed = (unsigned)v;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << arg << "\n";
+            return -1;
+        }
+        const char* v = argv[++i];
+        if (arg == "--pacing") {
+            if (!FramePacer::parseMode(v, pacing))
+                std::cerr << "Modo de ritmo desconhecido: " << v << "\n";
+        } else if (arg == "--fps") {
+            targetFps = std::strtod(v, nullptr);
+        } else if (arg == "--capture") {
+            captureDest = v;
+        } else if (arg == "--capture-format") {
+            if (!FrameCapture::parseFormat(v, captureFormat))
+                std::cerr << "Formato de captura desconhecido: " << v << "\n";
+        } else if (arg == "--capture-frames") {
+            captureFrames = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--cols") {
+            cols = std::atoi(v);
+        } else if (arg == "--rows") {
+            rows = std::atoi(v);
+        } else {
+            std::cerr << "Opcao desconhecida: " << arg << "\n";
+            return -1;
+        }
+    }
+    if (cols < 1 || cols > WINDOW_W || rows < 1 || rows > WINDOW_H) {
+        std::cerr << "Grade invalida: --cols 1.." << WINDOW_W << ", --rows 1.." << WINDOW_H << "\n";
+        return -1;
+    }
+
     // 1) Inicializa GLFW
     if(!glfwInit()){
         std::cerr<<"Failed to init GLFW\n";
@@ -249,48 +559,94 @@ int main(){
     GLint projLoc = glGetUniformLocation(shaderProgram,"projection");
     glUniformMatrix4fv(projLoc,1,GL_FALSE,glm::value_ptr(projection));
 
+    GLint rectSizeLoc = glGetUniformLocation(shaderProgram,"rectSize");
+
     // 6) Inicializa jogo e callbacks
-    initGrid();
+    rectW = WINDOW_W / float(cols);
+    rectH = WINDOW_H / float(rows);
+    glUniform2f(rectSizeLoc, rectW, rectH);
+    std::cout << "Semente da grade: " << seed << " (" << cols << "x" << rows << ")\n";
+    initGrid(seed);
+    auto regionsStart = std::chrono::steady_clock::now();
+    int strips = buildRegions();
+    std::printf("Regioes: %zu em %.2f ms (%d faixa%s)\n", regions.size(),
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - regionsStart).count(),
+                strips, strips == 1 ? "" : "s");
+    uploadGrid();
     glfwSetMouseButtonCallback(window,mouse_button_callback);
     glfwSetKeyCallback(window,key_callback);
+    pacer.init(window, pacing, targetFps);
+    std::cout << "Ritmo dos frames: " << FramePacer::modeName(pacing) << "\n";
+
+    FrameCapture capture;
+    if (!captureDest.empty() && capture.start(captureDest, captureFormat)) {
+        pacer.setContinuous(true);   // um frame por volta, mesmo sem cliques
+        std::cout << "Capturando frames em " << captureDest << "\n";
+    }
+
+    // Placar na janela: um draw para fundo e texto
+    TextRenderer text;
+    text.init(WINDOW_W, WINDOW_H);
+    TextLayout hud;
 
     // 7) Main loop
-    while(!glfwWindowShouldClose(window)){
+    uint64_t frames = 0;
+    alloc_stats::Counters allocs0 = alloc_stats::now();
+    while(pacer.beginFrame()){
         // se esgotou tentativas ou todos removidos, encerra
-        bool anyAlive=false;
-        for(auto& r: grid) if(r.alive){ anyAlive=true; break; }
-        if(!anyAlive || attempts>=MAX_ATTEMPTS) break;
+        if(aliveCount<=0 || attempts>=MAX_ATTEMPTS) break;
+        frameArena.reset();
+        ++frames;
+
+        if (hudDirty) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "PONTOS %d   TENTATIVAS %d/%d   MODO %s",
+                          score, attempts, MAX_ATTEMPTS,
+                          removalMode == RemovalMode::Region ? "REGIAO" : "CORES");
+            text.layout(line, 2.0f, hud);
+            hudDirty = false;
+        }
 
+        alloc_stats::NoAllocScope noAlloc("desenho");
         glClearColor(0.15f,0.15f,0.15f,1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
         glUseProgram(shaderProgram);
         glBindVertexArray(quadVAO);
 
-        // desenha cada retângulo
-        for(auto& r: grid){
-            if(!r.alive) continue;
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(r.pos,0.0f));
-            model = glm::scale(model, glm::vec3(RECT_W,RECT_H,1.0f));
-            GLint modelLoc = glGetUniformLocation(shaderProgram,"model");
-            glUniformMatrix4fv(modelLoc,1,GL_FALSE,glm::value_ptr(model));
+        // desenha a grade inteira em uma chamada; removidos são descartados no VS
+        glDrawArraysInstanced(GL_TRIANGLES,0,6,(GLsizei)grid.size());
 
-            GLint colorLoc = glGetUniformLocation(shaderProgram,"inputColor");
-            glUniform4f(colorLoc, r.color.r, r.color.g, r.color.b, 1.0f);
+        glBindVertexArray(0);
 
-            glDrawArrays(GL_TRIANGLES,0,6);
+        text.rect(0.0f, 0.0f, hud.width + 16.0f, hud.height + 8.0f, TextColor::shade());
+        text.add(hud, 8.0f, 6.0f, TextColor::white());
+        text.flush();
+        noAlloc.end();
+        if (capture.active()) {
+            int fbW, fbH;
+            glfwGetFramebufferSize(window, &fbW, &fbH);
+            capture.capture(fbW, fbH);
+            if (captureFrames && capture.captured() >= captureFrames) glfwSetWindowShouldClose(window, true);
         }
-
-        glBindVertexArray(0);
         glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
     // 8) Final
+    Logger::instance().flush();
+    if (capture.active()) {
+        capture.finish();
+        std::printf("Captura: %llu frames gravados em %s; %llu esperas pela GPU, %llu pelo disco\n",
+                    (unsigned long long)capture.written(), captureDest.c_str(),
+                    (unsigned long long)capture.gpuStalls(), (unsigned long long)capture.diskStalls());
+    }
     std::cout<<"\n=== Game Over ===\n"
              <<"Final Score: "<<score<<"\n"
              <<"Attempts Used: "<<attempts<<" / "<<MAX_ATTEMPTS<<"\n";
+    alloc_stats::Counters allocs = alloc_stats::now() - allocs0;
+    std::printf("Alocacoes: %llu em %llu frames (%.2f por frame, %.1f KB); arena: pico %zu bytes\n",
+                (unsigned long long)allocs.allocs, (unsigned long long)frames,
+                frames ? double(allocs.allocs) / frames : 0.0, allocs.bytes / 1024.0, frameArena.peak());
 
     glfwTerminate();
     return 0;
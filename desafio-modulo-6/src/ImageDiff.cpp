@@ -0,0 +1,164 @@
+// ImageDiff.cpp
+// Compara imagens capturadas (PNG/PPM, include/frame_capture.h) com imagens de
+// referência ("golden"), para conferir que uma mudança na renderização não mudou os
+// pixels.
+//
+// Um pixel é diferente quando algum canal RGB difere mais que a tolerância; a
+// comparação falha quando a fração de pixels diferentes passa de --max-diff, ou quando
+// os tamanhos não batem.
+//
+// Uso: ImageDiff <atual> <referencia> [--tolerance N] [--max-diff F] [--diff saida]
+//   <atual> e <referencia> são dois arquivos ou dois diretórios; com diretórios, cada
+//   imagem da referência é comparada com a de mesmo nome no atual (faltar é falha).
+//   --tolerance  diferença aceita por canal, 0..255 (padrão 2)
+//   --max-diff   fração de pixels diferentes aceita, 0..1 (padrão 0)
+//   --diff       grava a imagem de diferenças (PNG): pixels diferentes em vermelho
+//                sobre a referência escurecida; com diretórios, um diretório
+// Saída: 0 se tudo passou, 1 se alguma comparação falhou, 2 em erro de uso/leitura.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "image_write.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Image {
+    int                  width = 0, height = 0;
+    std::vector<uint8_t> rgb;
+};
+
+bool loadImage(const std::string& path, Image& img) {
+    int n = 0;
+    unsigned char* data = stbi_load(path.c_str(), &img.width, &img.height, &n, 3);
+    if (!data) {
+        std::cerr << "Nao foi possivel ler " << path << " (" << stbi_failure_reason() << ")\n";
+        return false;
+    }
+    img.rgb.assign(data, data + size_t(img.width) * img.height * 3);
+    stbi_image_free(data);
+    return true;
+}
+
+struct DiffOptions {
+    int         tolerance = 2;
+    double      maxDiff = 0.0;
+    std::string diffOut;   // arquivo (modo arquivo) ou diretório (modo diretório)
+};
+
+// 0 passou, 1 falhou, 2 erro
+int compare(const std::string& current, const std::string& golden, const std::string& label,
+            const std::string& diffPath, const DiffOptions& opt) {
+    Image a, b;
+    if (!loadImage(current, a) || !loadImage(golden, b)) return 2;
+    if (a.width != b.width || a.height != b.height) {
+        std::printf("%s: tamanho %dx%d, referencia %dx%d -> FALHOU\n", label.c_str(), a.width, a.height,
+                    b.width, b.height);
+        return 1;
+    }
+
+    const size_t pixels = size_t(a.width) * a.height;
+    size_t differing = 0;
+    int    worst = 0;
+    std::vector<uint8_t> diff(diffPath.empty() ? 0 : pixels * 3);
+    for (size_t p = 0; p < pixels; ++p) {
+        const uint8_t* pa = &a.rgb[p * 3];
+        const uint8_t* pb = &b.rgb[p * 3];
+        int d = std::max({ std::abs(pa[0] - pb[0]), std::abs(pa[1] - pb[1]), std::abs(pa[2] - pb[2]) });
+        worst = std::max(worst, d);
+        bool differs = d > opt.tolerance;
+        differing += differs;
+        if (!diff.empty()) {
+            uint8_t* out = &diff[p * 3];
+            if (differs) {
+                out[0] = 255;
+                out[1] = out[2] = 0;
+            } else {
+                uint8_t g = uint8_t((pb[0] * 77 + pb[1] * 150 + pb[2] * 29) >> 10);   // ~25% da luminância
+                out[0] = out[1] = out[2] = g;
+            }
+        }
+    }
+
+    const double fraction = pixels ? double(differing) / double(pixels) : 0.0;
+    const bool   pass = fraction <= opt.maxDiff;
+    std::printf("%s: %zu pixels diferentes (%.4f%%), maior diferenca %d -> %s\n", label.c_str(), differing,
+                fraction * 100.0, worst, pass ? "ok" : "FALHOU");
+    if (!diff.empty() && differing > 0 && !image_write::png(diffPath.c_str(), diff.data(), a.width, a.height))
+        std::cerr << "Nao foi possivel gravar " << diffPath << "\n";
+    return pass ? 0 : 1;
+}
+
+bool isImage(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    return ext == ".png" || ext == ".ppm";
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    DiffOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a.rfind("--", 0) != 0) {
+            paths.push_back(a);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Falta o valor de " << a << "\n";
+            return 2;
+        }
+        const char* v = argv[++i];
+        if (a == "--tolerance") opt.tolerance = std::atoi(v);
+        else if (a == "--max-diff") opt.maxDiff = std::atof(v);
+        else if (a == "--diff") opt.diffOut = v;
+        else {
+            std::cerr << "Opcao desconhecida: " << a << "\n";
+            return 2;
+        }
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Uso: ImageDiff <atual> <referencia> [--tolerance N] [--max-diff F] [--diff saida]\n";
+        return 2;
+    }
+
+    const fs::path current = paths[0], golden = paths[1];
+    if (!fs::is_directory(golden)) return compare(current.string(), golden.string(), current.string(), opt.diffOut, opt);
+
+    // Diretórios: todas as imagens da referência, em ordem de nome
+    std::vector<fs::path> names;
+    for (const auto& e : fs::directory_iterator(golden))
+        if (e.is_regular_file() && isImage(e.path())) names.push_back(e.path().filename());
+    std::sort(names.begin(), names.end());
+    if (names.empty()) {
+        std::cerr << "Nenhuma imagem em " << golden.string() << "\n";
+        return 2;
+    }
+    if (!opt.diffOut.empty()) fs::create_directories(opt.diffOut);
+
+    int failed = 0, errors = 0;
+    for (const fs::path& name : names) {
+        const fs::path cur = current / name;
+        if (!fs::exists(cur)) {
+            std::printf("%s: nao existe no atual -> FALHOU\n", name.string().c_str());
+            ++failed;
+            continue;
+        }
+        std::string diffPath;
+        if (!opt.diffOut.empty()) diffPath = (fs::path(opt.diffOut) / name.stem()).string() + "_diff.png";
+        int r = compare(cur.string(), (golden / name).string(), name.string(), diffPath, opt);
+        failed += r == 1;
+        errors += r == 2;
+    }
+    std::printf("%zu imagens: %zu ok, %d falharam\n", names.size(), names.size() - failed - errors, failed + errors);
+    return errors ? 2 : failed ? 1 : 0;
+}
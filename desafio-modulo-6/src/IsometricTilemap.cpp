@@ -1,5 +1,26 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#define ALLOC_STATS_IMPLEMENTATION   // conta as alocações do executável (antes do frame_profiler.h)
+#include "alloc_stats.h"
+#include "gl_resources.h"
+#include "transform2d.h"
+#include "ecs.h"
+#include "job_system.h"
+#include "frame_profiler.h"
+#include "file_watcher.h"
+#include "fov.h"
+#include "cow_grid.h"
+#include "snapshot.h"
+#include "frame_uniforms.h"
+#include "bitmap_text.h"
+#include "logger.h"
+#include "frame_arena.h"
+#include "input_queue.h"
+#include "frame_pacer.h"
+#include "render_target_pool.h"
+#include "dynamic_resolution.h"
+#include "frame_capture.h"
+#include "map_gen.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -7,35 +28,103 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <random>
 #include <chrono>
+#include <cmath>
 #include <algorithm>
-#include <sstream>
+#include <iterator>
 #include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
 
 typedef unsigned int uint;
-const uint SCR_W = 800, SCR_H = 600;
-const int MAP_H = 15;
-const int MAP_W = 15;
-int mapData[MAP_H][MAP_W];
-// Array para armazenar os IDs originais dos tiles
-int originalMapData[MAP_H][MAP_W];
+const uint SCR_W = 800, SCR_H = 600;   // tamanho inicial; a janela pode ser redimensionada
+// Tamanho do mapa, lido do arquivo (loadMapFromFile); tudo que é por célula é
+// dimensionado no carregamento
+int mapH = 0;
+int mapW = 0;
+// Grades com cópia na escrita (include/cow_grid.h): o save tira uma foto delas e a
+// lê em outra thread enquanto o jogo continua escrevendo
+CowGrid<int> mapData(0, 0, 0);
+// Grade para armazenar os IDs originais dos tiles
+CowGrid<int> originalMapData(0, 0, 0);
+// Altura de cada célula em níveis (0 = chão), linha a linha; a coluna desenha um tile por nível
+std::vector<uint8_t> heightData;
+
+inline int heightAt(int i, int j) { return heightData[size_t(i) * mapW + j]; }
+
+const int   MAX_LEVELS = 4;       // níveis 0..MAX_LEVELS-1
+const int   MAX_STEP   = 1;       // maior diferença de altura que o jogador sobe/desce
+const float LEVEL_H    = 16.0f;   // deslocamento na tela por nível (1/4 da altura do tile)
 
 
 const int PLAYER_INITIAL_TILE_ID = 0; // Exemplo: assumindo que o tile 0 é sempre caminhável e seguro para iniciar
 const int HIGHLIGHT_TILE_ID = 6; // ID do tile para destacar a posição atual do jogador
 
 // ===========================================
-// Variáveis Globais do Jogador
+// Entidades e Componentes
 // ===========================================
-int playerGridX = MAP_W / 2;
-int playerGridY = MAP_H / 2;
+// O estado do jogo vive no ECS (include/ecs.h): o jogador, cada item e a sessão
+// são entidades; os sistemas percorrem os componentes em ordem de memória.
+struct GridPos {
+    int x;
+    int y;
+};
+
+struct PlayerAnim {
+    int frameX;   // coluna na spritesheet
+    int frameY;   // linha (direção)
+};
+
+struct ItemInfo {
+    GLuint texture; // ID da textura OpenGL do cristal (sem posse)
+    int    type;    // Para identificar o tipo de item (pode ser usado para pontuação, etc.)
+    int    spec;    // índice em itemSpecs (o save guarda quais ainda existem)
+};
+
+struct GameState {
+    bool gameOver; // Tocou em um tile de game over
+    bool won;      // Coletou todos os itens
+};
+
+ecs::World  world;
+ecs::Entity player  = world.create(GridPos{ 0, 0 }, PlayerAnim{ 0, 3 }); // Linha inicial para "para baixo"
+ecs::Entity session = world.create(GameState{ false, false });
+
+// Células do minimapa a redesenhar (ver updateMinimap); quem muda o mapa, os itens ou a
+// névoa marca a célula, e o frame sem mudanças não percorre nada
+std::vector<int>     minimapDirty;
+std::vector<uint8_t> minimapDirtyFlag;   // uma por célula
+
+void markMinimapCell(int x, int y) {
+    int c = y * mapW + x;
+    if (minimapDirtyFlag[c]) return;
+    minimapDirtyFlag[c] = 1;
+    minimapDirty.push_back(c);
+}
+
+// Dados temporários do frame (listas de coleta, células do minimapa); zerada no começo
+// de cada frame, então nada dali pode ser guardado para o próximo
+FrameArena frameArena(64 * 1024);
+
+// Mensagem temporária do HUD (coleta, fim de jogo, save); o console continua com o log
+std::string hudMessage;
+double      hudMessageUntil = 0.0;
+
+void showHudMessage(const std::string& msg, double seconds = 2.5) {
+    hudMessage = msg;
+    hudMessageUntil = glfwGetTime() + seconds;
+}
+
 float playerMoveSpeed = 1.0f;
-int playerAnimationFrameX = 0;
-int playerAnimationFrameY = 3; // Linha inicial para "para baixo"
 double lastFrameTime = 0.0;
 
 // Variáveis para controle de tempo para animação do jogador
@@ -47,27 +136,10 @@ int g_animationDirection = 0;
 const int PLAYER_SPRITE_RUN_FRAMES = 7;
 const int PLAYER_SPRITE_ROWS = 4;
 
-// Variável de estado do jogo
-bool isGameOver = false; // Variável para controlar o estado do jogo
-bool hasWon = false; // Variável para controlar se o jogador venceu
-
-// ===========================================
-// Estrutura para os Itens
-// ===========================================
-struct GameItem {
-    int gridX;
-    int gridY;
-    GLuint textureID; // Agora armazena o ID da textura OpenGL diretamente
-    bool collected;   // Se o item foi coletado (para futura lógica)
-    int type;         // Para identificar o tipo de item (pode ser usado para pontuação, etc.)
-};
-
-std::vector<GameItem> gameItems;
-
-// IDs das texturas para os cristais individuais
-GLuint darkRedCrystalTexture;
-GLuint whiteCrystalTexture;
-GLuint yellowCrystalTexture;
+// Texturas dos cristais individuais (os itens guardam só o ID, sem posse)
+gl::Texture darkRedCrystalTexture;
+gl::Texture whiteCrystalTexture;
+gl::Texture yellowCrystalTexture;
 GLuint gameOverTileTexture; // Nova textura para o tile de game over
 
 // Ajuste os tamanhos para os cristais individuais, se necessário.
@@ -79,30 +151,48 @@ const float ITEM_SINGLE_SPRITE_H = 32.0f; // Altura de um sprite individual de i
 // ===========================================
 // Controle de Entrada
 // ===========================================
-bool g_keysPressed[GLFW_KEY_LAST + 1] = {false};
-bool g_keysHandled[GLFW_KEY_LAST + 1] = {false};
+// Pressionamentos em ordem de chegada; o laço do frame trata um a um, então toques
+// curtos ou vários no mesmo frame não se perdem (ver input_queue.h)
+InputQueue   g_input;
+InputLatency g_inputLatency;   // do evento ao swap do frame que mostra o efeito
+FramePacer   g_pacer;          // jogo por turnos: por padrão só desenha quando algo muda
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
-    if (key >= 0 && key <= GLFW_KEY_LAST)
-    {
-        if (action == GLFW_PRESS)
-        {
-            g_keysPressed[key] = true;
-        }
-        else if (action == GLFW_RELEASE)
-        {
-            g_keysPressed[key] = false;
-            g_keysHandled[key] = false;
-        }
+    // só pressionamentos viram ações; segurar a tecla não repete o movimento
+    if (key >= 0 && key <= GLFW_KEY_LAST && action == GLFW_PRESS) {
+        g_input.push(key, action, mods, glfwGetTime());
+        g_pacer.requestRedraw();
     }
 }
 
+// O tamanho é lido no começo de cada frame; aqui só pede o frame novo
+void framebuffer_size_callback(GLFWwindow *window, int width, int height)
+{
+    g_pacer.requestRedraw();
+}
+
+// Teclas de movimento: deslocamento na grade e linha da animação
+struct MoveKey {
+    int key, dx, dy, animY;
+};
+const MoveKey MOVE_KEYS[] = {
+    { GLFW_KEY_W,  1,  1, 2 },   // Nordeste
+    { GLFW_KEY_E,  0,  1, 2 },   // Nordeste (alternativa para sensação de WASD)
+    { GLFW_KEY_S, -1, -1, 3 },   // Sudoeste (para frente)
+    { GLFW_KEY_A,  1, -1, 1 },   // Sudeste
+    { GLFW_KEY_Q,  1,  0, 1 },   // Leste (ajuda para movimento diagonal)
+    { GLFW_KEY_Z,  0, -1, 1 },   // Noroeste (ajuda para movimento diagonal)
+    { GLFW_KEY_X, -1,  0, 3 },   // Sudoeste (ajuda para movimento diagonal)
+    { GLFW_KEY_D, -1,  1, 0 },   // Noroeste
+};
+
 // ===========================================
 // Carregamento de Texturas e Inicialização de Geometria
 // ===========================================
-// A função loadTexture permanece a mesma, pois carrega uma única imagem por vez.
-GLuint loadTexture(const char *path)
+// A função loadTexture carrega uma única imagem por vez; a textura é liberada
+// quando o handle retornado sai de escopo.
+gl::Texture loadTexture(const char *path)
 {
     stbi_set_flip_vertically_on_load(true);
     int w, h, n;
@@ -110,7 +200,7 @@ GLuint loadTexture(const char *path)
     if (!data)
     {
         std::cerr << "Failed to load " << path << "\n";
-        return 0;
+        return {};
     }
     GLenum fmt;
     if (n == 4) fmt = GL_RGBA;
@@ -118,11 +208,10 @@ GLuint loadTexture(const char *path)
     else {
         std::cerr << "Formato de imagem nao suportado (canais: " << n << ") para " << path << "\n";
         stbi_image_free(data);
-        return 0;
+        return {};
     }
 
-    GLuint t;
-    glGenTextures(1, &t);
+    gl::Texture t = gl::Texture::create();
     glBindTexture(GL_TEXTURE_2D, t);
     glTexImage2D(GL_TEXTURE_2D, 0, fmt, w, h, 0, fmt, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
@@ -135,7 +224,8 @@ GLuint loadTexture(const char *path)
     return t;
 }
 
-GLuint quadVAO;
+gl::VertexArray quadVAO;
+gl::Buffer      quadVBO;
 void initQuad()
 {
     float V[] = {
@@ -147,11 +237,10 @@ void initQuad()
             0.5f,  0.5f,  1.0f, 1.0f, // Canto superior direito
             0.5f, -0.5f,  1.0f, 0.0f  // Canto inferior direito
     };
-    GLuint VBO;
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &VBO);
+    quadVAO = gl::VertexArray::create();
+    quadVBO = gl::Buffer::create();
     glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(V), V, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
@@ -167,14 +256,66 @@ const char *vsSrc = R"glsl(
 #version 330 core
 layout(location=0) in vec2 aPos;
 layout(location=1) in vec2 aUV;
-uniform mat4 projection;
-uniform mat4 model;
+layout(std140) uniform Frame {   // ver frame_uniforms.h
+    mat4  viewProj;
+    vec2  cameraPos;
+    vec2  viewport;
+    float time;
+    float deltaTime;
+};
+uniform vec3 model[2];   // linhas da afim 2x3
+uniform vec2 depthKey;   // z = depthKey.x * y + depthKey.y (ver DepthRange)
 uniform vec2 texScale;
 uniform vec2 texOffset;
 out vec2 UV;
 void main(){
     UV = aUV * texScale + texOffset;
-    gl_Position = projection * model * vec4(aPos,0,1);
+    vec3 p = vec3(aPos,1);
+    float y = dot(model[1],p);
+    gl_Position = viewProj * vec4(dot(model[0],p), y, depthKey.x * y + depthKey.y, 1);
+}
+)glsl";
+
+// Tiles: um único draw instanciado; afim, ID do tile e chave de profundidade por
+// instância. O quadro de animação sai do ID, da tabela tileAnim e do tempo
+const char *tileVsSrc = R"glsl(
+#version 330 core
+layout(location=0) in vec2 aPos;
+layout(location=1) in vec2 aUV;
+layout(location=2) in vec3 iRow0;
+layout(location=3) in vec3 iRow1;
+layout(location=4) in float iTile;
+layout(location=5) in vec2 iDepthKey;
+layout(location=6) in vec2 iFogUV;      // centro do texel da célula na textura de névoa
+layout(std140) uniform Frame {   // ver frame_uniforms.h
+    mat4  viewProj;
+    vec2  cameraPos;
+    vec2  viewport;
+    float time;
+    float deltaTime;
+};
+uniform vec2 texScale;                  // tamanho de um tile no tileset (em UV)
+uniform int tilesetCols;
+uniform vec4 tileAnim[16];              // por ID: primeiro quadro, nº de quadros, quadros/s, tremular
+out vec2 UV;
+flat out vec2 FogUV;
+flat out float Flicker;
+void main(){
+    int frame = int(iTile + 0.5);
+    Flicker = 1.0;
+    if (frame < 16 && tileAnim[frame].y > 0.0) {
+        vec4 a = tileAnim[frame];
+        // fase por célula (FogUV é único por célula)
+        float phase = fract(sin(dot(iFogUV, vec2(12.9898, 78.233))) * 43758.5453);
+        float t = time * a.z + phase * a.y;
+        frame = int(a.x) + int(mod(floor(t), a.y));
+        Flicker = 1.0 - a.w * (0.5 + 0.5 * sin(6.2831853 * (time * a.z * 0.5 + phase)));
+    }
+    UV = aUV * texScale + vec2(frame % tilesetCols, frame / tilesetCols) * texScale;
+    FogUV = iFogUV;
+    vec3 p = vec3(aPos,1);
+    float y = dot(iRow1,p);
+    gl_Position = viewProj * vec4(dot(iRow0,p), y, iDepthKey.x * y + iDepthKey.y, 1);
 }
 )glsl";
 
@@ -194,6 +335,24 @@ void main(){
 }
 )glsl";
 
+// Tiles: brilho pela névoa de guerra (1 = visível, escuro = explorado)
+const char *tileFsSrc = R"glsl(
+#version 330 core
+in vec2 UV;
+flat in vec2 FogUV;
+flat in float Flicker;
+out vec4 Frag;
+uniform sampler2D spriteTex;
+uniform sampler2D fogTex;
+void main(){
+    vec4 texColor = texture(spriteTex, UV);
+    if (texColor.a < 0.05) discard;
+    float light = texture(fogTex, FogUV).r;
+    if (light == 0.0) discard;   // nunca visto
+    Frag = vec4(texColor.rgb * light * Flicker, texColor.a);
+}
+)glsl";
+
 static GLuint compileShader(GLenum t, const char *src)
 {
     GLuint s = glCreateShader(t);
@@ -211,11 +370,11 @@ static GLuint compileShader(GLenum t, const char *src)
     return s;
 }
 
-static GLuint createProgram()
+static gl::Program createProgram(const char *vertexSrc = vsSrc, const char *fragmentSrc = fsSrc)
 {
-    GLuint vs = compileShader(GL_VERTEX_SHADER, vsSrc);
-    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fsSrc);
-    GLuint p = glCreateProgram();
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vertexSrc);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fragmentSrc);
+    gl::Program p = gl::Program::create();
     glAttachShader(p, vs);
     glAttachShader(p, fs);
     glLinkProgram(p);
@@ -233,7 +392,8 @@ static GLuint createProgram()
     return p;
 }
 
-GLuint outlineVAO;
+gl::VertexArray outlineVAO;
+gl::Buffer      outlineVBO;
 void initOutline()
 {
     float C[] = {
@@ -241,11 +401,10 @@ void initOutline()
             0.5f, 0.5f,
             0.5f, -0.5f,
             -0.5f, -0.5f};
-    GLuint vbo;
-    glGenVertexArrays(1, &outlineVAO);
-    glGenBuffers(1, &vbo);
+    outlineVAO = gl::VertexArray::create();
+    outlineVBO = gl::Buffer::create();
     glBindVertexArray(outlineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, outlineVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(C), C, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
@@ -255,10 +414,39 @@ void initOutline()
 // ===========================================
 // Propriedades dos Tiles
 // ===========================================
+
+// Lê números de uma linha sem criar um stream por linha (os loaders também rodam na
+// recarga a quente, com o jogo aberto)
+struct LineReader {
+    const char* p;
+    explicit LineReader(const std::string& line) : p(line.c_str()) {}
+
+    bool next(int& v) {
+        char* end;
+        long x = std::strtol(p, &end, 10);
+        if (end == p) return false;
+        v = (int)x;
+        p = end;
+        return true;
+    }
+    bool next(float& v) {
+        char* end;
+        float x = std::strtof(p, &end);
+        if (end == p) return false;
+        v = x;
+        p = end;
+        return true;
+    }
+};
+
 std::map<int, bool> tileWalkableProperties; // tileID -> isWalkable
 std::map<int, bool> tileGameOverProperties; // tileID -> isGameOver
+std::map<int, bool> tileOpaqueProperties;   // tileID -> bloqueia a visão
 
-bool loadTilePropertiesFromFile(const std::string& filename) {
+// Lê o arquivo de propriedades para as tabelas dadas (sem tocar no estado do jogo;
+// a recarga a quente usa isto fora da thread principal)
+bool parseTilePropertiesFile(const std::string& filename, std::map<int, bool>& walkable, std::map<int, bool>& gameOver,
+                             std::map<int, bool>& opaque) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Erro: Nao foi possivel abrir o arquivo de propriedades dos tiles: " << filename << std::endl;
@@ -273,27 +461,36 @@ bool loadTilePropertiesFromFile(const std::string& filename) {
             continue;
         }
 
-        std::stringstream ss(line);
+        LineReader ss(line);
         int tileID;
         int isWalkableInt;
         int isGameOverInt = 0; // Padrão: não é tile de game over
+        int isOpaqueInt = 0;   // Padrão: não bloqueia a visão
 
-        // Formato esperado: tileID isWalkable [isGameOver]
-        if (!(ss >> tileID >> isWalkableInt)) {
-            std::cerr << "Erro de formato na linha " << lineNumber << " do arquivo de propriedades dos tiles. Esperado: tileID isWalkable [isGameOver]. Linha: " << line << std::endl;
+        // Formato esperado: tileID isWalkable [isGameOver [isOpaque]]
+        if (!(ss.next(tileID) && ss.next(isWalkableInt))) {
+            std::cerr << "Erro de formato na linha " << lineNumber << " do arquivo de propriedades dos tiles. Esperado: tileID isWalkable [isGameOver [isOpaque]]. Linha: " << line << std::endl;
             continue;
         }
 
         // Tenta ler isGameOver opcionalmente
-        if (ss >> isGameOverInt) {
-            tileGameOverProperties[tileID] = (isGameOverInt == 1);
+        if (ss.next(isGameOverInt)) {
+            gameOver[tileID] = (isGameOverInt == 1);
         } else {
-            tileGameOverProperties[tileID] = false; // Se não especificado, não é tile de game over
+            gameOver[tileID] = false; // Se não especificado, não é tile de game over
         }
+        opaque[tileID] = ss.next(isOpaqueInt) && isOpaqueInt == 1;
 
-        tileWalkableProperties[tileID] = (isWalkableInt == 1);
+        walkable[tileID] = (isWalkableInt == 1);
     }
     file.close();
+    return true;
+}
+
+bool loadTilePropertiesFromFile(const std::string& filename) {
+    if (!parseTilePropertiesFile(filename, tileWalkableProperties, tileGameOverProperties, tileOpaqueProperties)) {
+        return false;
+    }
     std::cout << "Propriedades dos tiles carregadas com sucesso de: " << filename << std::endl;
     return true;
 }
@@ -305,7 +502,7 @@ bool isTileWalkable(int tileID) {
         return it->second; // Retorna a propriedade de caminhabilidade definida
     }
     // Se o tileID não estiver no mapa, assume que é intransitável por padrão (segurança)
-    std::cerr << "Aviso: Tile ID " << tileID << " nao encontrado nas propriedades. Assumindo como intransitavel." << std::endl;
+    LOG_WARN("Aviso: Tile ID %d nao encontrado nas propriedades. Assumindo como intransitavel.", tileID);
     return false;
 }
 
@@ -318,65 +515,213 @@ bool isTileGameOver(int tileID) {
     return false; // Se não estiver definido, não é um tile de game over
 }
 
+// Tiles sem a coluna isOpaque (ou desconhecidos) não bloqueiam a visão
+bool isTileOpaque(int tileID) {
+    auto it = tileOpaqueProperties.find(tileID);
+    return it != tileOpaqueProperties.end() && it->second;
+}
 
 // ===========================================
-// Carregamento do Mapa e Geração de Itens
+// Tiles animados
 // ===========================================
-bool loadMapFromFile(const std::string& filename) {
+// Tabela lida de tile_animations.txt e enviada uma vez para o shader dos tiles, que
+// escolhe o quadro e o brilho a partir do uniform "time": a CPU não reescreve mapData
+// nem instâncias por causa da animação. Cada célula ganha uma fase própria no shader,
+// para a água não piscar toda em uníssono.
+const int MAX_ANIMATED_TILE_ID = 16;   // IDs 0..15 podem ser animados (tamanho do array no shader)
+
+struct TileAnimation {
+    float firstFrame;   // índice no tileset do primeiro quadro
+    float frameCount;   // 0 = sem animação
+    float fps;          // quadros por segundo (também a frequência do tremular)
+    float flicker;      // 0..1: quanto o brilho oscila
+};
+TileAnimation tileAnimations[MAX_ANIMATED_TILE_ID] = {};
+
+// No modo sob demanda, tiles animados pedem frames só nesta taxa
+const double ON_DEMAND_ANIM_FPS = 15.0;
+
+bool hasTileAnimations() {
+    for (const TileAnimation& a : tileAnimations)
+        if (a.frameCount > 1.0f || (a.frameCount > 0.0f && a.flicker > 0.0f)) return true;
+    return false;
+}
+
+bool loadTileAnimationsFromFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Erro: Nao foi possivel abrir o arquivo do mapa: " << filename << std::endl;
+        std::cerr << "Aviso: Nao foi possivel abrir " << filename << "; tiles sem animacao." << std::endl;
         return false;
     }
 
-    int fileMapH, fileMapW;
-    file >> fileMapH >> fileMapW;
-
-    if (fileMapH != MAP_H || fileMapW != MAP_W) {
-        std::cerr << "Aviso: Dimensoes do mapa no arquivo (" << fileMapH << "x" << fileMapW
-                  << ") nao correspondem as dimensoes esperadas (" << MAP_H << "x" << MAP_W << ")." << std::endl;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        LineReader ss(line);
+        int tileID, first, count;
+        float fps, flicker = 0.0f;
+        // Formato esperado: tileID primeiroQuadro nQuadros quadrosPorSegundo [tremular]
+        if (!(ss.next(tileID) && ss.next(first) && ss.next(count) && ss.next(fps))) {
+            std::cerr << "Erro de formato na linha " << lineNumber << " de " << filename << ": " << line << std::endl;
+            continue;
+        }
+        ss.next(flicker);
+        if (tileID < 0 || tileID >= MAX_ANIMATED_TILE_ID || first < 0 || count < 1 || fps <= 0.0f) {
+            std::cerr << "Aviso: Animacao invalida na linha " << lineNumber << " (IDs animaveis: 0.."
+                      << MAX_ANIMATED_TILE_ID - 1 << "). Ignorando." << std::endl;
+            continue;
+        }
+        tileAnimations[tileID] = { (float)first, (float)count, fps, std::max(0.0f, std::min(flicker, 1.0f)) };
     }
+    std::cout << "Animacoes dos tiles carregadas de: " << filename << std::endl;
+    return true;
+}
 
-    playerGridY = MAP_H / 2;
-    playerGridX = MAP_W / 2;
 
-    for (int i = 0; i < MAP_H; ++i) {
-        for (int j = 0; j < MAP_W; ++j) {
-            if (!(file >> mapData[i][j])) {
-                std::cerr << "Erro: Falha ao ler o tile em [" << i << "][" << j << "] do arquivo." << std::endl;
-                return false;
+// ===========================================
+// Carregamento do Mapa e Geração de Itens
+// ===========================================
+// Maior lado aceito na leitura; a névoa e o minimapa ainda precisam caber em
+// GL_MAX_TEXTURE_SIZE (conferido no main)
+const int MAX_MAP_SIDE = 32768;
+
+bool isBinaryMapFile(const std::string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+// Lê um mapa e o seu tamanho. map.txt: "altura largura", os IDs dos tiles (linha a
+// linha) e, se houver, um segundo bloco com a altura de cada célula; sem ele o mapa é
+// plano. Arquivos .bin vêm do MapGen (include/map_gen.h). Não toca no estado do jogo
+bool parseMapFile(const std::string& filename, int& h, int& w, std::vector<int>& tiles, std::vector<uint8_t>& heights) {
+    std::vector<int> levels;   // alturas como lidas, ajustadas no fim
+    if (isBinaryMapFile(filename)) {
+        GeneratedMap m;
+        if (!readMapBinary(filename, m) || m.width > MAX_MAP_SIDE || m.height > MAX_MAP_SIDE) {
+            std::cerr << "Erro: " << filename << " nao e um map.bin valido (ou passa de "
+                      << MAX_MAP_SIDE << " celulas por lado)." << std::endl;
+            return false;
+        }
+        h = m.height;
+        w = m.width;
+        tiles.assign(m.tiles.begin(), m.tiles.end());
+        levels.assign(m.heights.begin(), m.heights.end());
+    } else {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Erro: Nao foi possivel abrir o arquivo do mapa: " << filename << std::endl;
+            return false;
+        }
+
+        if (!(file >> h >> w) || h <= 0 || w <= 0 || h > MAX_MAP_SIDE || w > MAX_MAP_SIDE) {
+            std::cerr << "Erro: Cabecalho do mapa invalido em " << filename << " (esperado 'altura largura', de 1 a "
+                      << MAX_MAP_SIDE << ")." << std::endl;
+            return false;
+        }
+
+        tiles.assign(size_t(h) * w, 0);
+        for (int i = 0; i < h; ++i) {
+            for (int j = 0; j < w; ++j) {
+                if (!(file >> tiles[size_t(i) * w + j])) {
+                    std::cerr << "Erro: Falha ao ler o tile em [" << i << "][" << j << "] do arquivo." << std::endl;
+                    return false;
+                }
             }
-            // Armazena o ID original do tile
-            originalMapData[i][j] = mapData[i][j];
-
-            // Garante que a posição inicial do jogador não seja um tile intransitável
-            if (i == playerGridY && j == playerGridX) {
-                if (!isTileWalkable(mapData[i][j]) || isTileGameOver(mapData[i][j])) {
-                    std::cerr << "Erro: O tile de inicio do personagem (" << mapData[i][j]
-                              << ") no centro do mapa [" << i << "][" << j
-                              << "] e intransitavel ou de game over. Por favor, ajuste o mapa." << std::endl;
+        }
+
+        levels.assign(size_t(h) * w, 0);
+        int first;
+        if (file >> first) {
+            levels[0] = first;
+            for (size_t k = 1; k < levels.size(); ++k) {
+                if (!(file >> levels[k])) {
+                    std::cerr << "Erro: Bloco de alturas incompleto (celula [" << k / w << "][" << k % w << "])." << std::endl;
                     return false;
                 }
             }
         }
     }
 
-    file.close();
-    std::cout << "Mapa carregado com sucesso de: " << filename << std::endl;
+    size_t clamped = 0;
+    heights.resize(levels.size());
+    for (size_t k = 0; k < levels.size(); ++k) {
+        int lv = levels[k];
+        if (lv < 0 || lv >= MAX_LEVELS) {
+            lv = std::max(0, std::min(lv, MAX_LEVELS - 1));
+            ++clamped;
+        }
+        heights[k] = uint8_t(lv);
+    }
+    if (clamped) {
+        std::cerr << "Aviso: " << clamped << " alturas fora de 0.." << MAX_LEVELS - 1 << "; ajustadas." << std::endl;
+    }
     return true;
 }
 
-// Nova função para carregar itens de um arquivo
-bool loadItemsFromFile(const std::string& filename) {
-    // Limpa os itens existentes antes de carregar novos
-    gameItems.clear();
+// Carrega o mapa e dimensiona pelo tamanho do arquivo as grades e as marcas do minimapa;
+// névoa, opacidade e minimapa são dimensionados nas suas inicializações
+bool loadMapFromFile(const std::string& filename) {
+    std::vector<int> tiles;
+    std::vector<uint8_t> heights;
+    int h = 0, w = 0;
+    if (!parseMapFile(filename, h, w, tiles, heights)) {
+        return false;
+    }
+
+    // O jogador começa no centro, que precisa ser transitável
+    const int startX = w / 2, startY = h / 2;
+    const int startTile = tiles[size_t(startY) * w + startX];
+    if (!isTileWalkable(startTile) || isTileGameOver(startTile)) {
+        std::cerr << "Erro: O tile de inicio do personagem (" << startTile
+                  << ") no centro do mapa [" << startY << "][" << startX
+                  << "] e intransitavel ou de game over. Por favor, ajuste o mapa." << std::endl;
+        return false;
+    }
 
+    mapH = h;
+    mapW = w;
+    mapData = CowGrid<int>(h, w, 0);
+    originalMapData = CowGrid<int>(h, w, 0);
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < w; ++j) {
+            mapData.set(i, j, tiles[size_t(i) * w + j]);
+            // Armazena o ID original do tile
+            originalMapData.set(i, j, tiles[size_t(i) * w + j]);
+        }
+    }
+    heightData.swap(heights);
+    minimapDirty.clear();
+    minimapDirtyFlag.assign(size_t(h) * w, 0);
+    world.get<GridPos>(player) = { startX, startY };
+
+    std::cout << "Mapa carregado com sucesso de: " << filename << " (" << h << "x" << w << ")" << std::endl;
+    return true;
+}
+
+// Uma linha válida de items.txt
+struct ItemSpec {
+    int x, y, type;
+    int line;   // só para mensagens
+
+    bool operator<(const ItemSpec& o) const {
+        if (x != o.x) return x < o.x;
+        if (y != o.y) return y < o.y;
+        return type < o.type;
+    }
+};
+
+// Lê os itens (formato e limites do mapa); a validação contra o mapa fica em spawnItem
+bool parseItemsFile(const std::string& filename, std::vector<ItemSpec>& items) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Erro: Nao foi possivel abrir o arquivo de itens: " << filename << std::endl;
         return false;
     }
 
+    items.clear();
     std::string line;
     int lineNumber = 0;
     while (std::getline(file, line)) {
@@ -386,71 +731,720 @@ bool loadItemsFromFile(const std::string& filename) {
             continue;
         }
 
-        std::stringstream ss(line);
+        LineReader ss(line);
         int gridX, gridY, textureType;
         // Lê as coordenadas X, Y e o tipo de textura
-        if (!(ss >> gridX >> gridY >> textureType)) {
+        if (!(ss.next(gridX) && ss.next(gridY) && ss.next(textureType))) {
             std::cerr << "Erro de formato na linha " << lineNumber << " do arquivo de itens: " << line << std::endl;
             continue;
         }
 
         // Verifica se as coordenadas estão dentro dos limites do mapa
-        if (gridX < 0 || gridX >= MAP_W || gridY < 0 || gridY >= MAP_H) {
+        if (gridX < 0 || gridX >= mapW || gridY < 0 || gridY >= mapH) {
             std::cerr << "Aviso: Item na linha " << lineNumber << " fora dos limites do mapa (" << gridX << ", " << gridY << "). Ignorando." << std::endl;
             continue;
         }
+        items.push_back({ gridX, gridY, textureType, lineNumber });
+    }
+    file.close();
+    return true;
+}
 
-        // Validação de caminhabilidade antes da posição do item
-        if (!isTileWalkable(mapData[gridY][gridX]) || isTileGameOver(mapData[gridY][gridX]) ||
-            (gridX == playerGridX && gridY == playerGridY)) {
-            std::cerr << "Aviso: Item na linha " << lineNumber << " em posicao intransitavel, de game over ou na posicao do jogador (" << gridX << ", " << gridY << "). Ignorando." << std::endl;
-            continue;
+// Todo item já criado, na ordem de criação (só cresce; o save marca quais foram coletados)
+std::vector<ItemSpec> itemSpecs;
+
+// Cria a entidade do item, se a posição for válida no mapa atual. spec >= 0 recria um
+// item já registrado (restauração de save)
+bool spawnItem(const ItemSpec& s, int spec = -1) {
+    const GridPos playerPos = world.get<GridPos>(player);
+
+    // Validação de caminhabilidade antes da posição do item
+    if (!isTileWalkable(mapData.get(s.y, s.x)) || isTileGameOver(mapData.get(s.y, s.x)) ||
+        (s.x == playerPos.x && s.y == playerPos.y)) {
+        std::cerr << "Aviso: Item na linha " << s.line << " em posicao intransitavel, de game over ou na posicao do jogador (" << s.x << ", " << s.y << "). Ignorando." << std::endl;
+        return false;
+    }
+
+    ItemInfo info;
+    info.type = s.type; // Armazena o tipo do item, caso precise para pontuação, etc.
+
+    // Atribui a textura com base no textureType
+    switch (s.type) {
+        case 0: // Exemplo: Tipo 0 para Dark Red Crystal
+            info.texture = darkRedCrystalTexture;
+            break;
+        case 1: // Exemplo: Tipo 1 para White Crystal
+            info.texture = whiteCrystalTexture;
+            break;
+        case 2: // Exemplo: Tipo 2 para Yellow Crystal
+            info.texture = yellowCrystalTexture;
+            break;
+        default:
+            std::cerr << "Aviso: Tipo de textura invalido (" << s.type << ") na linha " << s.line << ". Usando Dark Red Crystal por padrao." << std::endl;
+            info.texture = darkRedCrystalTexture; // Padrão
+            break;
+    }
+    if (spec < 0) {
+        spec = (int)itemSpecs.size();
+        itemSpecs.push_back(s);
+    }
+    info.spec = spec;
+    world.create(GridPos{ s.x, s.y }, info);
+    markMinimapCell(s.x, s.y);
+    return true;
+}
+
+// Nova função para carregar itens de um arquivo
+bool loadItemsFromFile(const std::string& filename) {
+    // Limpa os itens existentes antes de carregar novos
+    std::vector<ecs::Entity> oldItems;
+    world.forEachEntity<ItemInfo>([&](ecs::Entity e, ItemInfo&) { oldItems.push_back(e); });
+    for (ecs::Entity e : oldItems) world.destroy(e);
+    itemSpecs.clear();
+
+    std::vector<ItemSpec> items;
+    if (!parseItemsFile(filename, items)) {
+        return false;
+    }
+    for (const ItemSpec& s : items) spawnItem(s);
+
+    std::cout << "Carregados " << world.count<ItemInfo>() << " itens do arquivo: " << filename << std::endl;
+    return true;
+}
+
+// ===========================================
+// Recarga a quente do mapa, de tile_properties.txt e dos itens
+// ===========================================
+// A thread do FileWatcher relê o arquivo alterado e compara com a última versão lida
+// (a base), gerando só as diferenças: células do mapa, propriedades e itens que
+// entraram/saíram. A thread principal aplica o pendente no começo do frame.
+// As instâncias de tile são montadas de mapData/heightData no recorte de cada frame
+// (a afim sai da posição da célula), então uma célula alterada não obriga a
+// recalcular mais nada. Um arquivo com outro tamanho é recusado.
+struct HotReload {
+    // bases: só a thread do watcher mexe nelas depois de start()
+    std::vector<int>      mapBase;
+    std::vector<uint8_t>  heightBase;
+    std::map<int, bool>   walkBase, overBase, opaqueBase;
+    std::vector<ItemSpec> itemsBase;   // ordenada
+
+    // diferenças pendentes (protegidas por m)
+    std::mutex m;
+    std::map<int, std::pair<int, int>> cells;      // i * mapW + j -> (novo tile, nova altura)
+    struct PropChange { int walkable, gameOver, opaque; };   // -1 = removido
+    std::map<int, PropChange> props;               // tileID -> novas propriedades
+    std::vector<std::pair<ItemSpec, bool>> items;  // (item, true = entrou / false = saiu), em ordem
+};
+HotReload hotReload;
+
+void onMapFileChanged(const std::string& path) {
+    std::vector<int> tiles;
+    std::vector<uint8_t> heights;
+    int h = 0, w = 0;
+    if (!parseMapFile(path, h, w, tiles, heights)) return;   // arquivo pela metade: espera o próximo evento
+    if (h != mapH || w != mapW) {
+        // as grades, a névoa e o minimapa foram dimensionados no carregamento
+        std::cerr << "Aviso: " << path << " mudou de tamanho (" << h << "x" << w
+                  << "); reinicie o jogo para carregar outro tamanho." << std::endl;
+        return;
+    }
+    std::lock_guard<std::mutex> lk(hotReload.m);
+    for (size_t k = 0; k < tiles.size(); ++k) {
+        if (tiles[k] != hotReload.mapBase[k] || heights[k] != hotReload.heightBase[k])
+            hotReload.cells[(int)k] = { tiles[k], heights[k] };
+    }
+    hotReload.mapBase.swap(tiles);
+    hotReload.heightBase.swap(heights);
+    g_pacer.wake();
+}
+
+void onTilePropertiesFileChanged(const std::string& path) {
+    std::map<int, bool> walk, over, opaque;
+    if (!parseTilePropertiesFile(path, walk, over, opaque)) return;
+    std::lock_guard<std::mutex> lk(hotReload.m);
+    for (const auto& w : walk) {
+        auto old = hotReload.walkBase.find(w.first);
+        if (old == hotReload.walkBase.end() || old->second != w.second ||
+            hotReload.overBase[w.first] != over[w.first] || hotReload.opaqueBase[w.first] != opaque[w.first])
+            hotReload.props[w.first] = { w.second ? 1 : 0, over[w.first] ? 1 : 0, opaque[w.first] ? 1 : 0 };
+    }
+    for (const auto& w : hotReload.walkBase) {
+        if (!walk.count(w.first)) hotReload.props[w.first] = { -1, -1, -1 };
+    }
+    hotReload.walkBase.swap(walk);
+    hotReload.overBase.swap(over);
+    hotReload.opaqueBase.swap(opaque);
+    g_pacer.wake();
+}
+
+void onItemsFileChanged(const std::string& path) {
+    std::vector<ItemSpec> items;
+    if (!parseItemsFile(path, items)) return;
+    std::sort(items.begin(), items.end());
+    std::vector<ItemSpec> added, removed;
+    std::set_difference(items.begin(), items.end(), hotReload.itemsBase.begin(), hotReload.itemsBase.end(), std::back_inserter(added));
+    std::set_difference(hotReload.itemsBase.begin(), hotReload.itemsBase.end(), items.begin(), items.end(), std::back_inserter(removed));
+    std::lock_guard<std::mutex> lk(hotReload.m);
+    for (const ItemSpec& s : removed) hotReload.items.push_back({ s, false });
+    for (const ItemSpec& s : added) hotReload.items.push_back({ s, true });
+    hotReload.itemsBase.swap(items);
+    g_pacer.wake();
+}
+
+// Aplica as diferenças pendentes (thread principal, fora dos jobs do frame); devolve
+// se o mapa ou as propriedades mudaram (a visão precisa ser refeita)
+bool applyHotReload() {
+    std::map<int, std::pair<int, int>> cells;
+    std::map<int, HotReload::PropChange> props;
+    std::vector<std::pair<ItemSpec, bool>> items;
+    {
+        std::lock_guard<std::mutex> lk(hotReload.m);
+        if (hotReload.cells.empty() && hotReload.props.empty() && hotReload.items.empty()) return false;
+        cells.swap(hotReload.cells);
+        props.swap(hotReload.props);
+        items.swap(hotReload.items);
+    }
+
+    // Propriedades primeiro: as validações de itens abaixo já usam as novas
+    for (const auto& p : props) {
+        if (p.second.walkable < 0) {
+            tileWalkableProperties.erase(p.first);
+            tileGameOverProperties.erase(p.first);
+            tileOpaqueProperties.erase(p.first);
+        } else {
+            tileWalkableProperties[p.first] = p.second.walkable == 1;
+            tileGameOverProperties[p.first] = p.second.gameOver == 1;
+            tileOpaqueProperties[p.first] = p.second.opaque == 1;
         }
+    }
 
-        GameItem newItem;
-        newItem.gridX = gridX;
-        newItem.gridY = gridY;
-        newItem.collected = false;
-        newItem.type = textureType; // Armazena o tipo do item, caso precise para pontuação, etc.
+    const GridPos playerPos = world.get<GridPos>(player);
+    for (const auto& c : cells) {
+        int i = c.first / mapW, j = c.first % mapW;
+        originalMapData.set(i, j, c.second.first);
+        heightData[size_t(c.first)] = uint8_t(c.second.second);
+        // sob o jogador fica o destaque; o tile novo volta quando ele sair
+        if (i != playerPos.y || j != playerPos.x) mapData.set(i, j, c.second.first);
+        markMinimapCell(j, i);
+    }
 
-        // Atribui a textura com base no textureType
-        switch (textureType) {
-            case 0: // Exemplo: Tipo 0 para Dark Red Crystal
-                newItem.textureID = darkRedCrystalTexture;
-                break;
-            case 1: // Exemplo: Tipo 1 para White Crystal
-                newItem.textureID = whiteCrystalTexture;
-                break;
-            case 2: // Exemplo: Tipo 2 para Yellow Crystal
-                newItem.textureID = yellowCrystalTexture;
-                break;
-            default:
-                std::cerr << "Aviso: Tipo de textura invalido (" << textureType << ") na linha " << lineNumber << ". Usando Dark Red Crystal por padrao." << std::endl;
-                newItem.textureID = darkRedCrystalTexture; // Padrão
-                break;
+    int spawned = 0, removed = 0;
+    for (const auto& it : items) {
+        const ItemSpec& s = it.first;
+        if (it.second) {
+            spawned += spawnItem(s) ? 1 : 0;
+            continue;
+        }
+        // saiu do arquivo: some do mundo se ainda não foi coletado
+        ecs::Entity found = ecs::NULL_ENTITY;
+        world.forEachEntity<GridPos, ItemInfo>([&](ecs::Entity e, const GridPos& at, const ItemInfo& info) {
+            if (at.x == s.x && at.y == s.y && info.type == s.type) found = e;
+        });
+        if (found != ecs::NULL_ENTITY) {
+            world.destroy(found);
+            markMinimapCell(s.x, s.y);
+            ++removed;
         }
-        gameItems.push_back(newItem);
     }
+    // itens novos reabrem uma partida que estava ganha
+    GameState& state = world.get<GameState>(session);
+    if (state.won && world.count<ItemInfo>() > 0) state.won = false;
 
-    file.close();
-    std::cout << "Carregados " << gameItems.size() << " itens do arquivo: " << filename << std::endl;
-    return true;
+    LOG_INFO("[recarga] %zu celulas, %zu propriedades, %d itens novos, %d itens removidos",
+             cells.size(), props.size(), spawned, removed);
+    return !cells.empty() || !props.empty();
 }
 
 // ===========================================
 // Nova função para verificar se todos os itens foram coletados
 // ===========================================
+// Itens coletados são destruídos, então basta ver se sobrou algum
 bool areAllItemsCollected() {
-    for (const auto& item : gameItems) {
-        if (!item.collected) {
-            return false; // Se um item não coletado for encontrado, retorna falso
+    return world.count<ItemInfo>() == 0;
+}
+
+// ===========================================
+// Save e load do estado do jogo (F5 salva, F9 carrega)
+// ===========================================
+// save.bin (include/snapshot.h), em ordem:
+//   "ISAV" versão | hash do mapa base | largura altura
+//   jogador x y direção | flags (bit 0 = game over, bit 1 = vitória)
+//   hash da lista de itens | nº de itens | bitset (1 = coletado)
+//   nº de células alteradas | por célula: distância desde a anterior, tile - tile base
+// Só entram as células de mapData diferentes de originalMapData, então o tamanho
+// depende do que mudou, não do tamanho do mapa.
+// O F5 copia na thread principal só o estado pequeno (jogador, flags, bitset) e os
+// ponteiros dos blocos das grades (view()); hash, diferença, codificação e escrita
+// rodam em uma thread própria. Não usa o JobSystem: o wait() do frame poderia acabar
+// executando o save na thread principal.
+const char*   SAVE_FILE    = "save.bin";
+const uint8_t SAVE_VERSION = 1;
+
+struct SaveJob {
+    CowGrid<int>::View   map, base;
+    int                  x, y, facing;
+    uint8_t              flags;
+    uint64_t             itemsHash;
+    uint64_t             itemCount;
+    std::vector<uint8_t> collected;   // bitset
+};
+
+std::thread       saveThread;
+std::atomic<bool> saveBusy{ false };
+
+uint64_t hashGrid(const CowGrid<int>::View& g) {
+    uint64_t h = fnv1a(nullptr, 0);
+    for (int i = 0; i < g.rows(); ++i) {
+        for (int j = 0; j < g.cols(); ++j) {
+            int v = g.get(i, j);
+            h = fnv1a(&v, sizeof(v), h);
         }
     }
-    return true; // Todos os itens foram coletados
+    return h;
+}
+
+uint64_t hashItemSpecs(const std::vector<ItemSpec>& specs) {
+    uint64_t h = fnv1a(nullptr, 0);
+    for (const ItemSpec& s : specs) {
+        int v[3] = { s.x, s.y, s.type };
+        h = fnv1a(v, sizeof(v), h);
+    }
+    return h;
 }
 
-int main()
+// Roda na thread do save: só lê as fotos e o que veio copiado no job
+void writeSave(SaveJob job) {
+    ByteWriter out;
+    out.raw("ISAV", 4);
+    out.u8(SAVE_VERSION);
+    out.u64(hashGrid(job.base));
+    out.varint(job.map.cols());
+    out.varint(job.map.rows());
+    out.varint(job.x);
+    out.varint(job.y);
+    out.varint(job.facing);
+    out.u8(job.flags);
+    out.u64(job.itemsHash);
+    out.varint(job.itemCount);
+    out.raw(job.collected.data(), job.collected.size());
+
+    ByteWriter cells;
+    uint64_t count = 0;
+    int64_t prev = -1;
+    for (int i = 0; i < job.map.rows(); ++i) {
+        for (int j = 0; j < job.map.cols(); ++j) {
+            int v = job.map.get(i, j), b = job.base.get(i, j);
+            if (v == b) continue;
+            int64_t idx = int64_t(i) * job.map.cols() + j;
+            cells.varint(uint64_t(idx - prev - 1));
+            cells.svarint(int64_t(v) - b);
+            prev = idx;
+            ++count;
+        }
+    }
+    out.varint(count);
+    out.raw(cells.data().data(), cells.data().size());
+
+    if (out.writeFile(SAVE_FILE)) {
+        LOG_INFO("[save] %s: %zu bytes, %llu celulas alteradas", SAVE_FILE, out.data().size(),
+                 (unsigned long long)count);
+    } else {
+        LOG_ERROR("Erro: Nao foi possivel gravar %s", SAVE_FILE);
+    }
+    saveBusy = false;
+}
+
+void requestSave() {
+    if (saveBusy.load()) {
+        LOG_INFO("[save] Save anterior ainda em andamento; ignorado.");
+        return;
+    }
+    if (saveThread.joinable()) saveThread.join();
+
+    SaveJob job;
+    job.map  = mapData.view();
+    job.base = originalMapData.view();
+    const GridPos& at = world.get<GridPos>(player);
+    job.x = at.x;
+    job.y = at.y;
+    job.facing = world.get<PlayerAnim>(player).frameY;
+    const GameState& state = world.get<GameState>(session);
+    job.flags = uint8_t((state.gameOver ? 1 : 0) | (state.won ? 2 : 0));
+    job.itemsHash = hashItemSpecs(itemSpecs);
+    job.itemCount = itemSpecs.size();
+    job.collected.assign((itemSpecs.size() + 7) / 8, 0);
+    for (size_t k = 0; k < itemSpecs.size(); ++k) job.collected[k / 8] |= uint8_t(1 << (k % 8));
+    world.forEach<ItemInfo>([&](const ItemInfo& item) {
+        job.collected[item.spec / 8] &= uint8_t(~(1 << (item.spec % 8)));
+    });
+
+    saveBusy = true;
+    saveThread = std::thread(writeSave, std::move(job));
+    showHudMessage("JOGO SALVO");
+}
+
+// Lê e valida o save inteiro antes de mexer em qualquer coisa; devolve false (e o jogo
+// segue como estava) se o arquivo não existe, está corrompido ou é de outro mapa/itens
+bool loadSave(const char* path) {
+    // um F5 pouco antes (até no mesmo frame, pela fila de teclas) pode estar gravando
+    if (saveThread.joinable()) saveThread.join();
+    std::vector<uint8_t> bytes;
+    if (!ByteReader::readFile(path, bytes)) {
+        std::cerr << "Aviso: Nenhum save em " << path << std::endl;
+        return false;
+    }
+    ByteReader in(std::move(bytes));
+    char magic[4] = {};
+    in.raw(magic, 4);
+    if (!in.ok() || std::string(magic, 4) != "ISAV" || in.u8() != SAVE_VERSION) {
+        std::cerr << "Erro: " << path << " nao e um save valido desta versao." << std::endl;
+        return false;
+    }
+    uint64_t baseHash = in.u64();
+    uint64_t w = in.varint(), h = in.varint();
+    uint64_t x = in.varint(), y = in.varint(), facing = in.varint();
+    uint8_t flags = in.u8();
+    uint64_t itemsHash = in.u64();
+    uint64_t itemCount = in.varint();
+    if (!in.ok() || w != mapW || h != mapH || baseHash != hashGrid(originalMapData.view())) {
+        std::cerr << "Erro: O save foi feito com outro mapa base." << std::endl;
+        return false;
+    }
+    if (itemCount != itemSpecs.size() || itemsHash != hashItemSpecs(itemSpecs)) {
+        std::cerr << "Erro: O save foi feito com outra lista de itens." << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> collected((itemCount + 7) / 8);
+    in.raw(collected.data(), collected.size());
+
+    uint64_t count = in.varint();
+    std::vector<std::pair<int, int>> cells;   // (i * mapW + j, tile), em ordem
+    int64_t prev = -1;
+    for (uint64_t k = 0; k < count && in.ok(); ++k) {
+        uint64_t gap = in.varint();
+        int64_t delta = in.svarint();
+        if (gap >= uint64_t(mapW) * mapH) break;
+        int64_t idx = prev + 1 + int64_t(gap);
+        if (idx >= int64_t(mapW) * mapH) break;
+        cells.push_back({ int(idx), int(originalMapData.get(int(idx / mapW), int(idx % mapW)) + delta) });
+        prev = idx;
+    }
+    if (!in.ok() || !in.atEnd() || cells.size() != count || x >= mapW || y >= mapH ||
+        facing >= PLAYER_SPRITE_ROWS) {
+        std::cerr << "Erro: " << path << " esta corrompido." << std::endl;
+        return false;
+    }
+
+    // Mapa: base + alterações; só as células que mudam de fato são escritas e redesenhadas
+    size_t next = 0;
+    for (int i = 0; i < mapH; ++i) {
+        for (int j = 0; j < mapW; ++j) {
+            int v = originalMapData.get(i, j);
+            if (next < cells.size() && cells[next].first == i * mapW + j) v = cells[next++].second;
+            if (mapData.get(i, j) == v) continue;
+            mapData.set(i, j, v);
+            markMinimapCell(j, i);
+        }
+    }
+
+    world.get<GridPos>(player) = { int(x), int(y) };
+    world.get<PlayerAnim>(player).frameY = int(facing);
+    world.get<GameState>(session) = { (flags & 1) != 0, (flags & 2) != 0 };
+
+    // Itens: recria os que ainda não tinham sido coletados
+    std::vector<ecs::Entity> oldItems;
+    world.forEachEntity<GridPos, ItemInfo>([&](ecs::Entity e, const GridPos& at, const ItemInfo&) {
+        oldItems.push_back(e);
+        markMinimapCell(at.x, at.y);
+    });
+    for (ecs::Entity e : oldItems) world.destroy(e);
+    for (size_t k = 0; k < itemSpecs.size(); ++k) {
+        if (!(collected[k / 8] & (1 << (k % 8)))) spawnItem(itemSpecs[k], int(k));
+    }
+
+    showHudMessage("JOGO CARREGADO");
+    LOG_INFO("[save] Carregado %s: %zu celulas alteradas, %zu itens restantes", path,
+             cells.size(), world.count<ItemInfo>());
+    return true;
+}
+
+// ===========================================
+// Profundidade
+// ===========================================
+// A ordem de desenho é resolvida pelo depth buffer, sem ordenar nada na CPU. Cada
+// ponto recebe uma profundidade de vista em px (menor = mais perto da câmera): na
+// projeção 2:1 (câmera a 30°) um ponto do chão com y de tela Y está a Y, e subir
+// e px o aproxima mais e/3. Faces de tile são planas, então a profundidade varia
+// por vértice; sprites são "em pé" e usam a profundidade do ponto de apoio.
+float viewDepth(float groundY, float elevation) {
+    return groundY - elevation / 3.0f;
+}
+
+// Converte profundidades para o intervalo do z da projeção (-1..1 => glm::ortho com
+// near -1 e far 1, em que z_ndc = -z) e monta a chave (a, b) do shader: z = a * y + b
+struct DepthRange {
+    float mid, scale;
+
+    DepthRange(float lo, float hi) : mid(0.5f * (lo + hi)), scale(1.8f / (hi - lo)) {}
+
+    // face plana na elevação e: ponto de tela y está no chão y - e, profundidade y - 4e/3;
+    // bias > 0 puxa para a frente (contorno sobre o tile)
+    glm::vec2 flat(float elevation, float bias = 0.0f) const {
+        return { -scale, (4.0f / 3.0f * elevation + mid + bias) * scale };
+    }
+    // sprite em pé com profundidade constante
+    glm::vec2 upright(float depth) const {
+        return { 0.0f, -(depth - mid) * scale };
+    }
+};
+
+// Um nível de uma coluna de tiles, pronto para o buffer de instâncias
+struct TileInstance {
+    Affine2D xf;
+    float    tile;          // ID no tileset; o shader resolve a animação
+    float    depthKey[2];
+    float    fogUV[2];
+};
+
+gl::VertexArray tileVAO;
+gl::Buffer      tileInstanceVBO;
+size_t          tileInstanceCapacity = 0;   // em instâncias
+
+// Aponta os atributos por instância (2..6) para o tileInstanceVBO atual
+void setupTileInstanceAttributes()
 {
+    glBindBuffer(GL_ARRAY_BUFFER, tileInstanceVBO);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)(offsetof(TileInstance, xf) + offsetof(Affine2D, v)));
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)(offsetof(TileInstance, xf) + offsetof(Affine2D, v) + 3 * sizeof(float)));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)offsetof(TileInstance, tile));
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)offsetof(TileInstance, depthKey));
+    glVertexAttribPointer(6, 2, GL_FLOAT, GL_FALSE, sizeof(TileInstance), (void *)offsetof(TileInstance, fogUV));
+    for (GLuint a = 2; a <= 6; ++a) {
+        glEnableVertexAttribArray(a);
+        glVertexAttribDivisor(a, 1);
+    }
+}
+
+// Mesmo quad do initQuad (atributos 0 e 1) + atributos por instância
+void initTileInstances()
+{
+    tileVAO = gl::VertexArray::create();
+    tileInstanceVBO = gl::Buffer::create();
+    glBindVertexArray(tileVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
+
+    // começa pequeno e dobra conforme a vista (uploadTileInstances): não depende do mapa
+    tileInstanceCapacity = 4096;
+    glBindBuffer(GL_ARRAY_BUFFER, tileInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, tileInstanceCapacity * sizeof(TileInstance), nullptr, GL_STREAM_DRAW);
+    setupTileInstanceAttributes();
+    glBindVertexArray(0);
+}
+
+// Envia as instâncias visíveis do frame (o buffer é reespecificado, sem esperar a GPU)
+void uploadTileInstances(const std::vector<TileInstance>& inst)
+{
+    if (inst.size() > tileInstanceCapacity) {
+        alloc_stats::AllowAllocScope grow;   // raro: só quando a vista passa do maior lote visto
+        while (tileInstanceCapacity < inst.size()) tileInstanceCapacity *= 2;
+        tileInstanceVBO = gl::Buffer::create();
+        glBindVertexArray(tileVAO);
+        setupTileInstanceAttributes();
+        glBindVertexArray(0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, tileInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, tileInstanceCapacity * sizeof(TileInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, inst.size() * sizeof(TileInstance), inst.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// ===========================================
+// Campo de visão e névoa de guerra
+// ===========================================
+const int FOV_RADIUS = 6;
+
+// Plano de opacidade: 1 onde o tile bloqueia a visão (coluna isOpaque das propriedades)
+std::vector<uint8_t> opacityPlane;   // mapH×mapW, linha a linha
+
+void rebuildOpacityPlane() {
+    opacityPlane.resize(size_t(mapH) * mapW);
+    for (int i = 0; i < mapH; ++i)
+        for (int j = 0; j < mapW; ++j)
+            opacityPlane[size_t(i) * mapW + j] = isTileOpaque(originalMapData.get(i, j)) ? 1 : 0;
+}
+
+// Estado da névoa por célula; a textura R8 (mapW×mapH) é amostrada pelo shader dos tiles
+FogOfWar    fog(0, 0);
+gl::Texture fogTexture;
+
+void initFogTexture() {
+    fog = FogOfWar(mapW, mapH);
+    fogTexture = gl::Texture::create();
+    glBindTexture(GL_TEXTURE_2D, fogTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);   // linhas de mapW bytes
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, mapW, mapH, 0, GL_RED, GL_UNSIGNED_BYTE, fog.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    fog.flushRows([](int, int, int) {});   // já foi inteira
+}
+
+// Refaz a visão a partir da célula do jogador e envia só os trechos de linha que mudaram.
+// Células mais de MAX_STEP níveis acima do jogador também bloqueiam a visão
+void updateFov(int px, int py) {
+    const int h0 = heightAt(py, px);
+    fog.update(px, py, FOV_RADIUS, [&](int x, int y) {
+        return opacityPlane[size_t(y) * mapW + x] != 0 || heightAt(y, x) - h0 > MAX_STEP;
+    });
+    glBindTexture(GL_TEXTURE_2D, fogTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    fog.flushRows([](int y, int x0, int n) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y, n, 1, GL_RED, GL_UNSIGNED_BYTE, fog.row(y) + x0);
+        for (int x = x0; x < x0 + n; ++x) markMinimapCell(x, y);
+    });
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// ===========================================
+// Minimapa
+// ===========================================
+// Textura RGBA com um texel por célula: cor do tipo de tile, itens e o jogador, só nas
+// células já exploradas. Só as células marcadas são recompostas e enviadas (por trechos
+// de linha); o desenho é um quad, deformado em losango para seguir a orientação do mapa.
+gl::Texture          minimapTexture;
+std::vector<uint8_t> minimapPixels;            // mapH×mapW×4, dimensionado no initMinimap
+int                  minimapPlayerCell = -1;   // onde o marcador do jogador está desenhado
+
+// Uma cor por ID de tile (IDs fora da tabela ficam cinza)
+const uint8_t MINIMAP_PALETTE[][3] = {
+    { 196, 164, 110 }, { 110, 160,  80 }, {  80, 130,  70 }, { 200,  70,  40 },
+    { 150, 150, 140 }, {  60,  90, 150 }, { 230, 230, 120 },
+};
+
+void initMinimap() {
+    minimapPixels.assign(size_t(mapH) * mapW * 4, 0);
+    minimapTexture = gl::Texture::create();
+    glBindTexture(GL_TEXTURE_2D, minimapTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mapW, mapH, 0, GL_RGBA, GL_UNSIGNED_BYTE, minimapPixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    // tudo começa inexplorado (transparente); a névoa marca as células conforme são vistas
+}
+
+// Recompõe e envia as células marcadas; playerCell = -1 esconde o marcador
+void updateMinimap(int playerCell) {
+    if (playerCell != minimapPlayerCell) {
+        if (minimapPlayerCell >= 0) markMinimapCell(minimapPlayerCell % mapW, minimapPlayerCell / mapW);
+        if (playerCell >= 0) markMinimapCell(playerCell % mapW, playerCell / mapW);
+        minimapPlayerCell = playerCell;
+    }
+    if (minimapDirty.empty()) return;
+
+    // itens nas células marcadas (só quando algo mudou, não a cada frame)
+    ArenaVector<int> itemCells(frameArena);
+    world.forEach<GridPos, ItemInfo>([&](const GridPos& at, const ItemInfo&) {
+        int c = at.y * mapW + at.x;
+        if (minimapDirtyFlag[c]) itemCells.push_back(c);
+    });
+    std::sort(itemCells.begin(), itemCells.end());
+    std::sort(minimapDirty.begin(), minimapDirty.end());
+
+    for (int c : minimapDirty) {
+        int i = c / mapW, j = c % mapW;
+        uint8_t* px = &minimapPixels[size_t(c) * 4];
+        if (!fog.explored(j, i)) {
+            px[0] = px[1] = px[2] = px[3] = 0;
+            continue;
+        }
+        uint8_t rgb[3] = { 128, 128, 128 };
+        int id = originalMapData.get(i, j);
+        if (id >= 0 && id < (int)(sizeof(MINIMAP_PALETTE) / sizeof(MINIMAP_PALETTE[0])))
+            std::copy(MINIMAP_PALETTE[id], MINIMAP_PALETTE[id] + 3, rgb);
+        if (c == playerCell) {
+            rgb[0] = rgb[1] = rgb[2] = 255;
+        } else if (std::binary_search(itemCells.begin(), itemCells.end(), c)) {
+            rgb[0] = 255; rgb[1] = 215; rgb[2] = 0;
+        }
+        bool lit = fog.visible(j, i) || c == playerCell;
+        for (int k = 0; k < 3; ++k) px[k] = lit ? rgb[k] : uint8_t(rgb[k] * 0.45f);
+        px[3] = 230;
+    }
+
+    // trechos contíguos da mesma linha viram um glTexSubImage2D cada
+    glBindTexture(GL_TEXTURE_2D, minimapTexture);
+    for (size_t a = 0; a < minimapDirty.size();) {
+        size_t b = a + 1;
+        while (b < minimapDirty.size() && minimapDirty[b] == minimapDirty[b - 1] + 1 &&
+               minimapDirty[b] / mapW == minimapDirty[a] / mapW) ++b;
+        int c0 = minimapDirty[a];
+        glTexSubImage2D(GL_TEXTURE_2D, 0, c0 % mapW, c0 / mapW, (GLsizei)(b - a), 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, &minimapPixels[size_t(c0) * 4]);
+        a = b;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (int c : minimapDirty) minimapDirtyFlag[c] = 0;
+    minimapDirty.clear();
+}
+
+int main(int argc, char** argv)
+{
+    // --profile imprime tempos das fases e utilização dos núcleos a cada 2 s
+    // --pacing ondemand|cap|vsync|off escolhe o ritmo do laço (--fps N para "cap")
+    // --res auto|<escala> resolução da cena (auto: ajusta ao orçamento de --budget ms)
+    // --capture <destino> grava os frames (--capture-format png|ppm|raw, --capture-frames N)
+    bool profile = false;
+    FramePacer::Mode pacing = FramePacer::Mode::OnDemand;
+    double targetFps = 60.0;
+    float fixedScale = 0.0f;   // 0 = automática
+    double sceneBudgetMs = 12.0;
+    std::string captureDest;
+    FrameCapture::Format captureFormat = FrameCapture::Format::Png;
+    uint64_t captureFrames = 0;   // 0 = até fechar a janela
+    std::string mapPath = "map.txt";     // .bin = formato binário do MapGen
+    std::string itemsPath = "items.txt";
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "--profile") profile = true;
+        else if (arg == "--map" && a + 1 < argc) mapPath = argv[++a];
+        else if (arg == "--items" && a + 1 < argc) itemsPath = argv[++a];
+        else if (arg == "--pacing" && a + 1 < argc) {
+            if (!FramePacer::parseMode(argv[++a], pacing)) {
+                std::cerr << "Modo de ritmo desconhecido: " << argv[a] << " (ondemand, cap, vsync, off)\n";
+                return -1;
+            }
+        }
+        else if (arg == "--fps" && a + 1 < argc) targetFps = std::atof(argv[++a]);
+        else if (arg == "--res" && a + 1 < argc) {
+            std::string v = argv[++a];
+            fixedScale = v == "auto" ? 0.0f : (float)std::atof(v.c_str());
+            if (v != "auto" && (fixedScale <= 0.0f || fixedScale > 1.0f)) {
+                std::cerr << "Escala invalida: " << v << " (auto ou um valor em (0, 1])\n";
+                return -1;
+            }
+        }
+        else if (arg == "--budget" && a + 1 < argc) sceneBudgetMs = std::atof(argv[++a]);
+        else if (arg == "--capture" && a + 1 < argc) captureDest = argv[++a];
+        else if (arg == "--capture-format" && a + 1 < argc) {
+            if (!FrameCapture::parseFormat(argv[++a], captureFormat)) {
+                std::cerr << "Formato de captura desconhecido: " << argv[a] << " (png, ppm, raw)\n";
+                return -1;
+            }
+        }
+        else if (arg == "--capture-frames" && a + 1 < argc) captureFrames = std::strtoull(argv[++a], nullptr, 10);
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -469,6 +1463,10 @@ int main()
     }
 
     glfwSetKeyCallback(win, key_callback);
+    glfwSetFramebufferSizeCallback(win, framebuffer_size_callback);
+    glfwSetWindowSizeLimits(win, 320, 240, GLFW_DONT_CARE, GLFW_DONT_CARE);
+    g_pacer.init(win, pacing, targetFps);
+    std::cout << "Ritmo dos frames: " << FramePacer::modeName(pacing) << std::endl;
 
     // 1. Carrega as propriedades dos tiles PRIMEIRO
     if (!loadTilePropertiesFromFile("tile_properties.txt")) {
@@ -476,25 +1474,80 @@ int main()
     }
 
     // 2. Carrega o mapa (que agora usa as propriedades dos tiles)
-    if (!loadMapFromFile("map.txt")) {
+    if (!loadMapFromFile(mapPath)) {
+        return -1;
+    }
+    // névoa e minimapa são texturas com um texel por célula
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (mapW > maxTextureSize || mapH > maxTextureSize) {
+        std::cerr << "Erro: O mapa (" << mapH << "x" << mapW << ") passa do GL_MAX_TEXTURE_SIZE desta placa ("
+                  << maxTextureSize << ")." << std::endl;
         return -1;
     }
 
-    glViewport(0, 0, SCR_W, SCR_H);
-    GLuint shader = createProgram();
+    gl::Program shader = createProgram();
     glUseProgram(shader);
 
-    glm::mat4 proj = glm::ortho(0.0f, float(SCR_W), 0.0f, float(SCR_H), -1.0f, 1.0f);
-    GLint locP = glGetUniformLocation(shader, "projection");
-    glUniformMatrix4fv(locP, 1, GL_FALSE, glm::value_ptr(proj));
 
     glUniform1i(glGetUniformLocation(shader, "spriteTex"), 0);
 
+    // Tileset: colunas x linhas de tiles
+    const int nCols = 7;
+    const int nRows = 1;
+
+    // Programa dos tiles (instanciado); a tabela de animação vai uma vez, só o tempo
+    // muda por frame
+    loadTileAnimationsFromFile("tile_animations.txt");
+    gl::Program tileShader = createProgram(tileVsSrc, tileFsSrc);
+    glUseProgram(tileShader);
+    GLint locTileTS = glGetUniformLocation(tileShader, "texScale");
+    glUniform1i(glGetUniformLocation(tileShader, "spriteTex"), 0);
+    glUniform1i(glGetUniformLocation(tileShader, "fogTex"), 1);
+    glUniform1i(glGetUniformLocation(tileShader, "tilesetCols"), nCols);
+    glUniform4fv(glGetUniformLocation(tileShader, "tileAnim"), MAX_ANIMATED_TILE_ID, &tileAnimations[0].firstFrame);
+    glUseProgram(shader);
+
+    // Câmera e tempo: um bloco uniform escrito uma vez por frame e lido pelos dois programas
+    // HUD e painel de desempenho (F3 alterna; começa ligado com --profile)
+    TextRenderer text;
+    text.init(SCR_W, SCR_H);
+    int textW = SCR_W, textH = SCR_H;
+    PerfOverlay perf;
+    bool showPerf = profile;
+    int drawCalls = 0, lastDrawCalls = 0;   // draws do frame atual / do anterior
+
+    // Cena num alvo fora da tela, em escala, ampliada para a janela (dynamic_resolution.h)
+    RenderTargetPool renderTargets;
+    DynamicResolution resolution;
+    resolution.init(sceneBudgetMs);
+    // Capturando, a escala fica em 1 (ou no --res dado): pixels que não dependem da GPU
+    if (fixedScale > 0.0f) resolution.setFixed(fixedScale);
+    else if (!captureDest.empty()) resolution.setFixed(1.0f);
+    std::cout << "Resolucao da cena: "
+              << (resolution.isAutomatic() ? "automatica" : "fixa")
+              << " (orcamento " << sceneBudgetMs << " ms)" << std::endl;
+
+    // Captura dos frames para imagens ou vídeo bruto (frame_capture.h)
+    FrameCapture capture;
+    if (!captureDest.empty()) {
+        if (!capture.start(captureDest, captureFormat)) return -1;
+        std::cout << "Capturando frames em " << captureDest << std::endl;
+    }
+
+    FrameUniformRing frameUniforms;
+    frameUniforms.init(0);
+    frameUniforms.attach(shader);
+    frameUniforms.attach(tileShader);
+
     initQuad();
     initOutline();
+    initTileInstances();
+    initFogTexture();
+    initMinimap();
 
-    GLuint tileset = loadTexture("resources/tileset.png");
-    GLuint playerSpriteSheet = loadTexture("resources/Vampires2_Run_full.png");
+    gl::Texture tileset = loadTexture("resources/tileset.png");
+    gl::Texture playerSpriteSheet = loadTexture("resources/Vampires2_Run_full.png");
 
     // CARREGANDO AS NOVAS TEXTURAS INDIVIDUAIS DOS CRISTAIS
     darkRedCrystalTexture = loadTexture("resources/Dark_red_ crystal1.png");
@@ -515,15 +1568,39 @@ int main()
 
 
     // 3. Carrega os itens do arquivo. A validação de posição agora usa as propriedades carregadas.
-    if (!loadItemsFromFile("items.txt")) {
+    if (!loadItemsFromFile(itemsPath)) {
         // Se o carregamento do arquivo falhar, você pode, opcionalmente, lidar com isso aqui.
         // Por exemplo, gerar itens aleatoriamente se o arquivo não for encontrado ou estiver vazio.
-        std::cerr << "Nao foi possivel carregar os itens do arquivo. Certifique-se de que 'items.txt' existe e esta formatado corretamente." << std::endl;
+        std::cerr << "Nao foi possivel carregar os itens do arquivo. Certifique-se de que '" << itemsPath << "' existe e esta formatado corretamente." << std::endl;
+    }
+
+    // 4. Recarga a quente: as bases partem do que acabou de ser carregado
+    hotReload.mapBase.resize(size_t(mapH) * mapW);
+    for (int i = 0; i < mapH; ++i)
+        for (int j = 0; j < mapW; ++j) hotReload.mapBase[size_t(i) * mapW + j] = originalMapData.get(i, j);
+    hotReload.heightBase = heightData;
+    hotReload.walkBase = tileWalkableProperties;
+    hotReload.overBase = tileGameOverProperties;
+    hotReload.opaqueBase = tileOpaqueProperties;
+    parseItemsFile(itemsPath, hotReload.itemsBase);
+    std::sort(hotReload.itemsBase.begin(), hotReload.itemsBase.end());
+    FileWatcher watcher;
+    watcher.watch(mapPath, onMapFileChanged);
+    watcher.watch("tile_properties.txt", onTilePropertiesFileChanged);
+    watcher.watch(itemsPath, onItemsFileChanged);
+    if (!watcher.start()) {
+        std::cerr << "Aviso: recarga a quente indisponivel; alteracoes nos arquivos exigem reiniciar." << std::endl;
     }
 
+    // 5. Visão inicial a partir do centro
+    rebuildOpacityPlane();
+    int fovX = world.get<GridPos>(player).x;
+    int fovY = world.get<GridPos>(player).y;
+    updateFov(fovX, fovY);
+
     // Armazena a posição anterior do jogador para restaurar o tile
-    int lastPlayerGridX = playerGridX;
-    int lastPlayerGridY = playerGridY;
+    int lastPlayerGridX = world.get<GridPos>(player).x;
+    int lastPlayerGridY = world.get<GridPos>(player).y;
 
     const int playerSpriteSheetTotalW = 448;
     const int playerSpriteSheetTotalH = 256;
@@ -539,6 +1616,23 @@ int main()
     glm::vec2 mapOriginOffset(0.0f, 0.0f);
 
     GLint locM = glGetUniformLocation(shader, "model");
+    GLint locZ = glGetUniformLocation(shader, "depthKey");
+
+    // Profundidades possíveis: do tile mais perto, no chão, até o topo do sprite mais
+    // alto na célula mais distante, com folga de um tile de cada lado
+    const float topElevation = (MAX_LEVELS - 1) * LEVEL_H + tileH;
+    const DepthRange depth(viewDepth(-tileH, topElevation), viewDepth((mapH + mapW) * halfH + tileH, 0.0f) + tileH);
+
+    // Os tiles não giram nem mudam de escala: todos têm a mesma afim 2x3 a menos da
+    // translação, que o recorte preenche para cada célula visível (uma afim guardada por
+    // célula não caberia nos mapas grandes)
+    Transform2DBatch tileXf;
+    tileXf.add(0.0f, 0.0f, tileW, tileH);
+    const Affine2D tileAffine = affineAt(tileXf, 0);
+
+    // Itens, jogador e contorno: lote refeito a cada frame (itens primeiro, na ordem de iteração do ECS)
+    Transform2DBatch dynXf;
+    std::vector<Affine2D> dynAffines;
     GLint locTS = glGetUniformLocation(shader, "texScale");
     GLint locTO = glGetUniformLocation(shader, "texOffset");
     GLint locOL = glGetUniformLocation(shader, "u_outline");
@@ -550,238 +1644,361 @@ int main()
 
     g_lastFrameTime = glfwGetTime();
 
-    const int nCols = 7;
-    const int nRows = 1;
+    // Preparo do frame (recorte e transformações) roda em tarefas; o envio para a GL
+    // continua só nesta thread, que também ajuda a executar as tarefas enquanto espera
+    JobSystem jobs;
+    FrameProfiler profiler(&jobs);
+    std::vector<std::vector<TileInstance>> rowInstances(mapH);
+    std::vector<TileInstance> tileInstances;
 
     // Este é o seu loop principal do jogo. Toda a lógica do jogo e renderização devem acontecer aqui.
-    while (!glfwWindowShouldClose(win))
+    alloc_stats::Counters frameAllocs0 = alloc_stats::now();
+    uint64_t lastFrameAllocs = 0;
+    const bool tilesAnimated = hasTileAnimations();
+    while (g_pacer.beginFrame())   // processa os eventos; no modo sob demanda espera algo mudar
     {
+        profiler.beginFrame();
+        lastDrawCalls = drawCalls;
+        drawCalls = 0;
+        alloc_stats::Counters allocsNow = alloc_stats::now();
+        lastFrameAllocs = allocsNow.allocs - frameAllocs0.allocs;
+        frameAllocs0 = allocsNow;
+        frameArena.reset();
         double currentTime = glfwGetTime();
         double deltaTime = currentTime - g_lastFrameTime;
         g_lastFrameTime = currentTime;
 
-        glfwPollEvents();
-
-        // Lógica do Jogo: Processa a entrada e atualiza o estado do jogo apenas se o jogo não tiver terminado ou sido vencido
-        if (!isGameOver && !hasWon) {
-            int newPlayerGridX = playerGridX;
-            int newPlayerGridY = playerGridY;
-            bool playerAttemptedMove = false;
-            int newPlayerAnimY = playerAnimationFrameY;
-
-            // Tratamento de entrada de movimento do jogador
-            if (g_keysPressed[GLFW_KEY_W] && !g_keysHandled[GLFW_KEY_W]) { // Nordeste
-                newPlayerGridY++; newPlayerGridX++;
-                newPlayerAnimY = 2; // Ajusta a linha de animação para esta direção
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_W] = true;
-            }
-            if (g_keysPressed[GLFW_KEY_E] && !g_keysHandled[GLFW_KEY_E]) { // Nordeste (alternativa para sensação de WASD)
-                newPlayerGridY++;
-                newPlayerAnimY = 2;
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_E] = true;
-            } else if (g_keysPressed[GLFW_KEY_S] && !g_keysHandled[GLFW_KEY_S]) { // Sudoeste (Para frente)
-                newPlayerGridY--; newPlayerGridX--;
-                newPlayerAnimY = 3; // Ajusta a linha de animação para esta direção
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_S] = true;
-            } else if (g_keysPressed[GLFW_KEY_A] && !g_keysHandled[GLFW_KEY_A]) { // Sudeste
-                newPlayerGridY--; newPlayerGridX++;
-                newPlayerAnimY = 1; // Ajusta a linha de animação para esta direção
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_A] = true;
-            } else if (g_keysPressed[GLFW_KEY_Q] && !g_keysHandled[GLFW_KEY_Q]) { // Leste (ajuda para movimento diagonal)
-                newPlayerGridX++;
-                newPlayerAnimY = 1;
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_Q] = true;
-            }
-            else if (g_keysPressed[GLFW_KEY_Z] && !g_keysHandled[GLFW_KEY_Z]) { // Noroeste (ajuda para movimento diagonal)
-                newPlayerGridY--;
-                newPlayerAnimY = 1; // Assumindo a mesma linha de animação que 'A' ou 'Q' para uma direção similar
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_Z] = true;
-            }
-            else if (g_keysPressed[GLFW_KEY_X] && !g_keysHandled[GLFW_KEY_X]) { // Sudoeste (ajuda para movimento diagonal)
-                newPlayerGridX--;
-                newPlayerAnimY = 3; // Assumindo a mesma linha de animação que 'S' ou 'A' para uma direção similar
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_X] = true;
-            }
-            else if (g_keysPressed[GLFW_KEY_D] && !g_keysHandled[GLFW_KEY_D]) { // Noroeste
-                newPlayerGridY++; newPlayerGridX--;
-                newPlayerAnimY = 0; // Ajusta a linha de animação para esta direção
-                playerAttemptedMove = true;
-                g_keysHandled[GLFW_KEY_D] = true;
-            }
-
-            if (playerAttemptedMove) {
-                // Verifica os limites do mapa e tiles intransitáveis
-                if (newPlayerGridX >= 0 && newPlayerGridX < MAP_W &&
-                    newPlayerGridY >= 0 && newPlayerGridY < MAP_H)
+        bool mapChanged = applyHotReload();   // antes de pegar referências: pode criar/destruir itens
+        if (mapChanged) rebuildOpacityPlane();
+
+        // Um passo do jogador; coleta e fim de jogo são verificados a cada passo. Pega os
+        // componentes na hora: o F9 pode ter recriado itens antes
+        auto movePlayer = [&](const MoveKey& m) {
+            GridPos&    playerPos  = world.get<GridPos>(player);
+            PlayerAnim& playerAnim = world.get<PlayerAnim>(player);
+            GameState&  state      = world.get<GameState>(session);
+            int newPlayerGridX = playerPos.x + m.dx;
+            int newPlayerGridY = playerPos.y + m.dy;
+            int newPlayerAnimY = m.animY;
+
+            // Verifica os limites do mapa e tiles intransitáveis
+            if (newPlayerGridX >= 0 && newPlayerGridX < mapW &&
+                newPlayerGridY >= 0 && newPlayerGridY < mapH)
+            {
+                // Usando a nova função isTileWalkable; degraus mais altos que MAX_STEP bloqueiam
+                int step = std::abs(heightAt(newPlayerGridY, newPlayerGridX) - heightAt(playerPos.y, playerPos.x));
+                if (isTileWalkable(originalMapData.get(newPlayerGridY, newPlayerGridX)) && step <= MAX_STEP) // Verifica caminhabilidade do tile original
                 {
-                    // Usando a nova função isTileWalkable
-                    if (isTileWalkable(originalMapData[newPlayerGridY][newPlayerGridX])) // Verifica caminhabilidade do tile original
-                    {
-                        // Se o jogador se moveu, restaure o tile anterior
-                        if (playerGridX != newPlayerGridX || playerGridY != newPlayerGridY) {
-                            mapData[lastPlayerGridY][lastPlayerGridX] = originalMapData[lastPlayerGridY][lastPlayerGridX];
-                        }
+                    // Se o jogador se moveu, restaure o tile anterior
+                    if (playerPos.x != newPlayerGridX || playerPos.y != newPlayerGridY) {
+                        mapData.set(lastPlayerGridY, lastPlayerGridX, originalMapData.get(lastPlayerGridY, lastPlayerGridX));
+                    }
 
-                        // Atualiza a posição do jogador
-                        playerGridX = newPlayerGridX;
-                        playerGridY = newPlayerGridY;
-                        playerAnimationFrameY = newPlayerAnimY;
+                    // Atualiza a posição do jogador
+                    playerPos.x = newPlayerGridX;
+                    playerPos.y = newPlayerGridY;
+                    playerAnim.frameY = newPlayerAnimY;
 
-                        // Armazena a nova posição como a "última" para o próximo frame
-                        lastPlayerGridX = playerGridX;
-                        lastPlayerGridY = playerGridY;
+                    // Armazena a nova posição como a "última" para o próximo frame
+                    lastPlayerGridX = playerPos.x;
+                    lastPlayerGridY = playerPos.y;
 
-                        // Mude o tile atual para o HIGHLIGHT_TILE_ID (6)
-                        mapData[playerGridY][playerGridX] = HIGHLIGHT_TILE_ID;
+                    // Mude o tile atual para o HIGHLIGHT_TILE_ID (6)
+                    mapData.set(playerPos.y, playerPos.x, HIGHLIGHT_TILE_ID);
 
-                        // Usando a nova função isTileGameOver
-                        if (isTileGameOver(originalMapData[playerGridY][playerGridX])) { // Use originalMapData para verificar se é um tile de game over
-                            isGameOver = true;
-                            std::cout << "Game Over! Voce tocou em um tile de game over!" << std::endl;
-                        }
+                    // Visão refeita a cada passo: vários passos num frame revelam o caminho todo
+                    fovX = playerPos.x;
+                    fovY = playerPos.y;
+                    updateFov(fovX, fovY);
 
-                        // Lógica de coleta de itens
-                        for (auto& item : gameItems) {
-                            if (!item.collected && item.gridX == playerGridX && item.gridY == playerGridY) {
-                                item.collected = true;
-                                std::cout << "Item coletado! Tipo: " << item.type << std::endl;
-                                // Verifica a condição de vitória imediatamente após coletar um item
-                                if (areAllItemsCollected()) {
-                                    hasWon = true;
-                                    std::cout << "Parabens! Voce coletou todos os itens e venceu o jogo!" << std::endl;
-                                }
-                            }
+                    // Usando a nova função isTileGameOver
+                    if (isTileGameOver(originalMapData.get(playerPos.y, playerPos.x))) { // Use originalMapData para verificar se é um tile de game over
+                        state.gameOver = true;
+                        LOG_INFO("Game Over! Voce tocou em um tile de game over!");
+                    }
+
+                    // Lógica de coleta de itens: itens coletados são destruídos depois da iteração
+                    ArenaVector<ecs::Entity> collected(frameArena);
+                    world.forEachEntity<GridPos, ItemInfo>([&](ecs::Entity e, const GridPos& at, const ItemInfo& item) {
+                        if (at.x == playerPos.x && at.y == playerPos.y) {
+                            collected.push_back(e);
+                            LOG_INFO("Item coletado! Tipo: %d", item.type);
+                            showHudMessage("CRISTAL COLETADO!", 1.5);
                         }
-                    } else {
-                        // Se o movimento for bloqueado, ainda atualiza a direção da animação
-                        playerAnimationFrameY = newPlayerAnimY;
+                    });
+                    for (ecs::Entity e : collected) world.destroy(e);
+                    // Verifica a condição de vitória imediatamente após coletar um item
+                    if (!collected.empty() && areAllItemsCollected()) {
+                        state.won = true;
+                        LOG_INFO("Parabens! Voce coletou todos os itens e venceu o jogo!");
                     }
                 } else {
-                    // Se o movimento for fora dos limites, ainda atualiza a direção da animação
-                    playerAnimationFrameY = newPlayerAnimY;
+                    // Se o movimento for bloqueado, ainda atualiza a direção da animação
+                    playerAnim.frameY = newPlayerAnimY;
                 }
-                playerAnimationFrameX = (int)(currentTime / g_animationSpeed) % PLAYER_SPRITE_RUN_FRAMES;
             } else {
-                playerAnimationFrameX = 0; // Reset para o frame ocioso se não houver movimento
+                // Se o movimento for fora dos limites, ainda atualiza a direção da animação
+                playerAnim.frameY = newPlayerAnimY;
+            }
+        };
+
+        // Entrada: cada pressionamento, na ordem em que chegou, vira uma ação.
+        // F5 salva (a gravação segue em outra thread); F9 volta ao último save
+        bool playerAttemptedMove = false;
+        InputEvent ev;
+        while (g_input.pop(ev)) {
+            bool acted = true;
+            if (ev.key == GLFW_KEY_F5) {
+                requestSave();
+            } else if (ev.key == GLFW_KEY_F3) {
+                showPerf = !showPerf;
+            } else if (ev.key == GLFW_KEY_F9) {
+                if (loadSave(SAVE_FILE)) {
+                    lastPlayerGridX = world.get<GridPos>(player).x;
+                    lastPlayerGridY = world.get<GridPos>(player).y;
+                } else {
+                    showHudMessage("SAVE INDISPONIVEL");
+                }
+            } else {
+                // movimento só com o jogo em andamento; depois do fim, a entrada é ignorada
+                const GameState& st = world.get<GameState>(session);
+                const MoveKey* m = std::find_if(std::begin(MOVE_KEYS), std::end(MOVE_KEYS),
+                                                [&](const MoveKey& k) { return k.key == ev.key; });
+                acted = m != std::end(MOVE_KEYS) && !st.gameOver && !st.won;
+                if (acted) {
+                    movePlayer(*m);
+                    playerAttemptedMove = true;
+                }
+            }
+            if (acted) g_inputLatency.pending(ev.time);
+        }
+
+        // Próximos frames sem entrada (modo sob demanda): animação dos tiles, fim da
+        // mensagem do HUD e painel de desempenho, que precisa de frames seguidos
+        if (tilesAnimated) g_pacer.wakeAt(currentTime + 1.0 / ON_DEMAND_ANIM_FPS);
+        if (currentTime < hudMessageUntil) g_pacer.wakeAt(hudMessageUntil);
+        g_pacer.setContinuous(showPerf || capture.active());
+
+        // Componentes do jogador e da sessão (itens ficam em outro arquétipo, então
+        // destruir itens durante o frame não move estes dados)
+        GridPos&    playerPos  = world.get<GridPos>(player);
+        PlayerAnim& playerAnim = world.get<PlayerAnim>(player);
+        GameState&  state      = world.get<GameState>(session);
+
+        // Animação e destaque do tile do jogador, com o jogo em andamento
+        if (!state.gameOver && !state.won) {
+            if (playerAttemptedMove) {
+                playerAnim.frameX = (int)(currentTime / g_animationSpeed) % PLAYER_SPRITE_RUN_FRAMES;
+            } else {
+                playerAnim.frameX = 0; // Reset para o frame ocioso se não houver movimento
                 // Garante que o tile atual do jogador ainda esteja destacado, mesmo se não houver movimento
-                mapData[playerGridY][playerGridX] = HIGHLIGHT_TILE_ID;
+                mapData.set(playerPos.y, playerPos.x, HIGHLIGHT_TILE_ID);
             }
         } else { // Se o jogo estiver encerrado (game over ou vitória)
             // Garante que o tile onde o jogador parou retorne ao original ou mostre o tile de game over
             // Se o jogo está encerrado e o jogador está em um tile de game over, ele pode permanecer como está
             // Caso contrário, restaure para o original
-            if (isGameOver) {
+            if (state.gameOver) {
                 // Se é um tile de game over, pode-se decidir se ele volta ao original ou permanece como tile de game over
                 // Neste caso, ele volta ao original para mostrar o tile que era antes de ativar o game over.
-                mapData[playerGridY][playerGridX] = originalMapData[playerGridY][playerGridX];
-            } else if (hasWon) {
-                mapData[playerGridY][playerGridX] = originalMapData[playerGridY][playerGridX];
-            }
-            // Desativa a entrada quando o jogo termina
-            for (int i = 0; i <= GLFW_KEY_LAST; ++i) {
-                g_keysPressed[i] = false;
-                g_keysHandled[i] = false;
+                mapData.set(playerPos.y, playerPos.x, originalMapData.get(playerPos.y, playerPos.x));
+            } else if (state.won) {
+                mapData.set(playerPos.y, playerPos.x, originalMapData.get(playerPos.y, playerPos.x));
             }
         }
 
-        // Código de Renderização
-        float playerWorldX = (playerGridY - playerGridX) * halfW + mapOriginOffset.x;
-        float playerWorldY = (playerGridY + playerGridX) * halfH + mapOriginOffset.y;
-
-        float cameraOffsetX = (SCR_W * 0.5f) - playerWorldX;
-        float cameraOffsetY = (SCR_H * 0.5f) - playerWorldY;
-
-        proj = glm::ortho(0.0f - cameraOffsetX, float(SCR_W) - cameraOffsetX, 0.0f - cameraOffsetY, float(SCR_H) - cameraOffsetY, -1.0f, 1.0f);
-        glUniformMatrix4fv(locP, 1, GL_FALSE, glm::value_ptr(proj));
-
-        glClearColor(0.2f, 0.2f, 0.2f, 1);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Visão: só refeita quando o jogador muda de célula ou o mapa muda
+        if (mapChanged || playerPos.x != fovX || playerPos.y != fovY) {
+            fovX = playerPos.x;
+            fovY = playerPos.y;
+            updateFov(fovX, fovY);
+        }
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glUniform1i(locOL, 0);
+        // Código de Renderização. O mundo visível segue o tamanho da janela (coordenadas de
+        // tela); a cena sai em pixels do framebuffer vezes a escala da resolução
+        int winW, winH, fbW, fbH;
+        glfwGetWindowSize(win, &winW, &winH);
+        glfwGetFramebufferSize(win, &fbW, &fbH);
+        winW = std::max(winW, 1);
+        winH = std::max(winH, 1);
+        if (winW != textW || winH != textH) {
+            text.resize(winW, winH);
+            textW = winW;
+            textH = winH;
+        }
+        resolution.setOutput(fbW, fbH);
+        const float viewW = float(winW), viewH = float(winH);
+
+        const float playerElevation = heightAt(playerPos.y, playerPos.x) * LEVEL_H;
+        float playerWorldX = (playerPos.y - playerPos.x) * halfW + mapOriginOffset.x;
+        float playerWorldY = (playerPos.y + playerPos.x) * halfH + mapOriginOffset.y;
+
+        float cameraOffsetX = (viewW * 0.5f) - playerWorldX;
+        float cameraOffsetY = (viewH * 0.5f) - (playerWorldY + playerElevation);
+
+        glm::mat4 proj = glm::ortho(0.0f - cameraOffsetX, viewW - cameraOffsetX, 0.0f - cameraOffsetY, viewH - cameraOffsetY, -1.0f, 1.0f);
+        FrameUniforms frameData{};
+        std::memcpy(frameData.viewProj, glm::value_ptr(proj), sizeof(frameData.viewProj));
+        frameData.cameraPos[0] = playerWorldX;
+        frameData.cameraPos[1] = playerWorldY + playerElevation;
+        frameData.viewport[0] = float(resolution.width());
+        frameData.viewport[1] = float(resolution.height());
+        // capturando, o relógio das animações anda 1/60 s por frame: a mesma execução
+        // gera as mesmas imagens em qualquer máquina
+        frameData.time = capture.active() ? float(capture.captured() / 60.0) : (float)currentTime;
+        frameData.deltaTime = (float)deltaTime;
+        frameUniforms.update(frameData);
 
-        // Renderização dos Tiles do Mapa
         float dsx_tile = 1.0f / float(nCols);
         float dsy_tile = 1.0f / float(nRows);
 
-        for (int i = 0; i < MAP_H; ++i)
+        // Preparo em tarefas: recorte dos tiles por faixas de linhas do mapa e, em
+        // paralelo, as transformações de itens/jogador/contorno; a junção das listas de
+        // tiles depende do recorte
+        size_t playerXf = 0, outlineXf = 0;
         {
-            for (int j = 0; j < MAP_W; ++j)
-            {
-                int idx = mapData[i][j];
-                float offx_tile = (float)(idx % nCols) * dsx_tile;
-                float offy_tile = (float)(idx / nCols) * dsy_tile;
-
-                float x = (i - j) * halfW + mapOriginOffset.x;
-                float y = (i + j) * halfH + mapOriginOffset.y;
+            FrameProfiler::ScopedPhase phase(profiler, "preparo");
+
+            // janela em coordenadas de mundo, alargada por meio tile
+            const float viewL = -cameraOffsetX - halfW, viewR = viewW - cameraOffsetX + halfW;
+            const float viewB = -cameraOffsetY - halfH, viewT = viewH - cameraOffsetY + halfH;
+            // Só as células que podem cair na janela: x = (i - j) * halfW e y = (i + j) * halfH
+            // limitam i - j e i + j (a coluna mais alta sobe até maxElevation), então o
+            // custo do recorte segue o tamanho da janela, não o do mapa
+            const float maxElevation = (MAX_LEVELS - 1) * LEVEL_H;
+            const int dMin = (int)std::floor((viewL - mapOriginOffset.x) / halfW);
+            const int dMax = (int)std::ceil((viewR - mapOriginOffset.x) / halfW);
+            const int sMin = (int)std::floor((viewB - maxElevation - mapOriginOffset.y) / halfH);
+            const int sMax = (int)std::ceil((viewT - mapOriginOffset.y) / halfH);
+            const int rowBegin = std::max(0, (int)std::floor((sMin + dMin) * 0.5f));
+            const int rowEnd = std::max(rowBegin, std::min(mapH, (int)std::ceil((sMax + dMax) * 0.5f) + 1));
+            JobSystem::Task cull = jobs.parallelFor(rowBegin, rowEnd, 4, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    std::vector<TileInstance>& row = rowInstances[i];
+                    row.clear();
+                    const int jBegin = std::max({ 0, sMin - (int)i, (int)i - dMax });
+                    const int jEnd = std::min({ mapW, sMax - (int)i + 1, (int)i - dMin + 1 });
+                    for (int j = jBegin; j < jEnd; ++j) {
+                        int h = heightAt((int)i, j);
+                        float x = ((int)i - j) * halfW + mapOriginOffset.x;
+                        float y = ((int)i + j) * halfH + mapOriginOffset.y;
+                        if (x < viewL || x > viewR || y + h * LEVEL_H < viewB || y > viewT) continue;
+                        if (!fog.explored(j, (int)i)) continue;   // nunca visto: nem entra no lote
+                        // coluna: níveis de baixo com o tile original, o topo com o atual (destaque)
+                        for (int l = 0; l <= h; ++l) {
+                            int idx = l == h ? mapData.get(i, j) : originalMapData.get(i, j);
+                            TileInstance inst;
+                            inst.xf = tileAffine;
+                            inst.xf.v[2] = x;
+                            inst.xf.v[5] = y + l * LEVEL_H;
+                            inst.tile = (float)idx;
+                            glm::vec2 key = depth.flat(l * LEVEL_H);
+                            inst.depthKey[0] = key.x;
+                            inst.depthKey[1] = key.y;
+                            inst.fogUV[0] = (j + 0.5f) / mapW;
+                            inst.fogUV[1] = (i + 0.5f) / mapH;
+                            row.push_back(inst);
+                        }
+                    }
+                }
+            });
+            JobSystem::Task merge = jobs.schedule([&] {
+                tileInstances.clear();
+                for (int i = rowBegin; i < rowEnd; ++i)
+                    tileInstances.insert(tileInstances.end(), rowInstances[i].begin(), rowInstances[i].end());
+            }, { cull });
+
+            // Transformações dinâmicas do frame, calculadas de uma vez
+            JobSystem::Task dynamic = jobs.schedule([&] {
+                dynXf.clear();
+                world.forEach<GridPos, ItemInfo>([&](const GridPos& at, const ItemInfo&) {
+                    float itemWorldX = (at.y - at.x) * halfW + mapOriginOffset.x;
+                    float itemWorldY = (at.y + at.x) * halfH + mapOriginOffset.y + heightAt(at.y, at.x) * LEVEL_H + (tileH * 0.5f); // Ajusta para ficar em cima do tile
+                    dynXf.add(itemWorldX, itemWorldY, ITEM_SINGLE_SPRITE_W, ITEM_SINGLE_SPRITE_H);
+                });
+                playerXf = dynXf.add(playerWorldX, playerWorldY + playerElevation + (tileH * 0.25f),
+                                     playerSingleSpriteW, playerSingleSpriteH);
+                outlineXf = dynXf.add(playerWorldX, playerWorldY + playerElevation, tileW, tileH);
+                computeAffines(dynXf, dynAffines);
+            });
+
+            jobs.wait(merge);
+            jobs.wait(dynamic);
+        }
 
-                float tileZ = (i + j) * 0.001f;
+        FrameProfiler::ScopedPhase submitPhase(profiler, "envio GL");
+        // do clear ao HUD nada aloca: listas prontas no preparo, lote de texto reservado
+        resolution.beginScene(renderTargets);   // pode pegar um alvo novo do pool (janela redimensionada)
+        alloc_stats::NoAllocScope noAlloc("envio GL");
+        glClearColor(0.2f, 0.2f, 0.2f, 1);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-                glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, tileZ)) * glm::scale(glm::mat4(1.0f), glm::vec3(tileW, tileH, 1));
-                glUniformMatrix4fv(locM, 1, GL_FALSE, glm::value_ptr(M));
-                glUniform2f(locTS, dsx_tile, dsy_tile);
-                glUniform2f(locTO, offx_tile, offy_tile);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-                glBindTexture(GL_TEXTURE_2D, tileset);
-                glBindVertexArray(quadVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-            }
-        }
+        // Renderização dos Tiles do Mapa: todas as colunas visíveis em um único draw;
+        // o depth buffer ordena níveis e células
+        uploadTileInstances(tileInstances);
+        glUseProgram(tileShader);
+        glUniform2f(locTileTS, dsx_tile, dsy_tile);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, fogTexture);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, tileset);
+        glBindVertexArray(tileVAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)tileInstances.size());
+        ++drawCalls;
+        glUseProgram(shader);
+        glUniform1i(locOL, 0);
 
-        // Renderização dos Itens
+        // Renderização dos Itens (em pé, apoiados no centro da célula); só os que estão à vista
         glUniform2f(locTS, 1.0f, 1.0f);
         glUniform2f(locTO, 0.0f, 0.0f);
 
-        for (const auto& item : gameItems) {
-            if (!item.collected) { // Renderiza apenas se não for coletado
-                float itemWorldX = (item.gridY - item.gridX) * halfW + mapOriginOffset.x;
-                float itemWorldY = (item.gridY + item.gridX) * halfH + mapOriginOffset.y + (tileH * 0.5f); // Ajusta para ficar em cima do tile
-                float itemZ = (item.gridY + item.gridX) * 0.001f + 0.2f; // Ordem Z: mais alto que o tile, mais baixo que o jogador
+        size_t k = 0;
+        world.forEach<GridPos, ItemInfo>([&](const GridPos& at, const ItemInfo& item) {
+            if (!fog.visible(at.x, at.y)) {
+                ++k;
+                return;
+            }
+            float groundY = (at.y + at.x) * halfH + mapOriginOffset.y;
+            glm::vec2 itemKey = depth.upright(viewDepth(groundY, heightAt(at.y, at.x) * LEVEL_H));
 
-                glm::mat4 M_item = glm::translate(glm::mat4(1.0f), glm::vec3(itemWorldX, itemWorldY, itemZ))
-                                   * glm::scale(glm::mat4(1.0f), glm::vec3(ITEM_SINGLE_SPRITE_W, ITEM_SINGLE_SPRITE_H, 1));
-                glUniformMatrix4fv(locM, 1, GL_FALSE, glm::value_ptr(M_item));
+            glUniform3fv(locM, 2, dynAffines[k++].rows());
+            glUniform2f(locZ, itemKey.x, itemKey.y);
 
-                glBindTexture(GL_TEXTURE_2D, item.textureID); // Vincula a textura específica do item
-                glBindVertexArray(quadVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-            }
-        }
+            glBindTexture(GL_TEXTURE_2D, item.texture); // Vincula a textura específica do item
+            glBindVertexArray(quadVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            ++drawCalls;
+        });
 
 
         // Renderização do Personagem do Jogador
-        if (!isGameOver && !hasWon) { // Renderiza o jogador apenas se o jogo ainda estiver ativo
+        if (!state.gameOver && !state.won) { // Renderiza o jogador apenas se o jogo ainda estiver ativo
             const float dsx_player = playerSingleSpriteW / playerSpriteSheetTotalW;
             const float dsy_player = playerSingleSpriteH / playerSpriteSheetTotalH;
 
-            float offx_player = playerAnimationFrameX * dsx_player;
-            float offy_player = playerAnimationFrameY * dsy_player;
+            float offx_player = playerAnim.frameX * dsx_player;
+            float offy_player = playerAnim.frameY * dsy_player;
 
             glUniform2f(locTS, dsx_player, dsy_player);
             glUniform2f(locTO, offx_player, offy_player);
 
-            float playerRenderX = (playerGridY - playerGridX) * halfW + mapOriginOffset.x;
-            float playerRenderY = (playerGridY + playerGridX) * halfH + mapOriginOffset.y + (tileH * 0.25f);
-            float playerZ = (playerGridY + playerGridX) * 0.001f + 0.5f;
+            // apoio nos pés (base do sprite), que ficam um pouco à frente do centro da célula
+            float feetY = playerWorldY + (tileH * 0.25f) - playerSingleSpriteH * 0.5f;
+            glm::vec2 playerKey = depth.upright(viewDepth(feetY, playerElevation));
 
-            glm::mat4 M_player = glm::translate(glm::mat4(1.0f), glm::vec3(playerRenderX, playerRenderY, playerZ))
-                                 * glm::scale(glm::mat4(1.0f), glm::vec3(playerSingleSpriteW, playerSingleSpriteH, 1));
-            glUniformMatrix4fv(locM, 1, GL_FALSE, glm::value_ptr(M_player));
+            glUniform3fv(locM, 2, dynAffines[playerXf].rows());
+            glUniform2f(locZ, playerKey.x, playerKey.y);
 
             glBindTexture(GL_TEXTURE_2D, playerSpriteSheet);
             glBindVertexArray(quadVAO);
             glDrawArrays(GL_TRIANGLES, 0, 6);
+            ++drawCalls;
         }
 
         // Renderização do Contorno do Tile do Jogador
-        if (!isGameOver && !hasWon) { // Mostra o contorno apenas se o jogo estiver ativo
+        if (!state.gameOver && !state.won) { // Mostra o contorno apenas se o jogo estiver ativo
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
             glUniform1i(locOL, 1);
             glUniform4f(locCLR, 1, 1, 1, 1);
@@ -791,20 +2008,125 @@ int main()
             glUniform2f(locTO, 0.0f, 0.0f);
 
             glBindVertexArray(outlineVAO);
-            {
-                float x_outline = (playerGridY - playerGridX) * halfW + mapOriginOffset.x;
-                float y_outline = (playerGridY + playerGridX) * halfH + mapOriginOffset.y;
-                glm::mat4 M_outline = glm::translate(glm::mat4(1.0f), glm::vec3(x_outline, y_outline, (playerGridY + playerGridX) * 0.001f + 0.1f)) * glm::scale(glm::mat4(1.0f), glm::vec3(tileW, tileH, 1));
-                glUniformMatrix4fv(locM, 1, GL_FALSE, glm::value_ptr(M_outline));
-                glDrawArrays(GL_LINE_LOOP, 0, 4);
-            }
+            glUniform3fv(locM, 2, dynAffines[outlineXf].rows());
+            glm::vec2 outlineKey = depth.flat(playerElevation, 1.0f);
+            glUniform2f(locZ, outlineKey.x, outlineKey.y);
+            glDrawArrays(GL_LINE_LOOP, 0, 4);
+            ++drawCalls;
             glUniform1i(locOL, 0);
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         }
 
+        // Minimapa no canto superior direito, por cima de tudo. A projeção do bloco Frame
+        // segue a câmera, então a posição de tela vira mundo subtraindo o deslocamento dela
+        updateMinimap(!state.gameOver && !state.won ? playerPos.y * mapW + playerPos.x : -1);
+        {
+            const float mmW = 90.0f, mmH = 45.0f;   // meia largura / meia altura do losango
+            const Affine2D mm{ { -mmW, mmW, viewW - mmW - 10.0f - cameraOffsetX,
+                                 mmH, mmH, viewH - mmH - 10.0f - cameraOffsetY } };
+            glDisable(GL_DEPTH_TEST);
+            glUniform3fv(locM, 2, mm.rows());
+            glUniform2f(locZ, 0.0f, 0.0f);
+            glUniform2f(locTS, 1.0f, 1.0f);
+            glUniform2f(locTO, 0.0f, 0.0f);
+            glBindTexture(GL_TEXTURE_2D, minimapTexture);
+            glBindVertexArray(quadVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            ++drawCalls;
+            glEnable(GL_DEPTH_TEST);
+        }
+        // amplia a cena para a janela; o HUD sai por cima, em resolução cheia
+        resolution.endScene();
+
+        // HUD: cristais, mensagens e fim de jogo; tudo (e o painel) sai em um draw
+        {
+            const float s = 2.0f;
+            int total = (int)itemSpecs.size(), left = (int)world.count<ItemInfo>();
+            text.rect(0.0f, 0.0f, 230.0f, 26.0f, TextColor::shade());
+            text.add(text.cached("CRISTAIS", s), 8.0f, 6.0f, TextColor::white());
+            char crystals[32];
+            std::snprintf(crystals, sizeof(crystals), "%d/%d", total - left, total);
+            text.text(8.0f + 9 * 6 * s, 6.0f, crystals, s, TextColor::yellow());
+
+            const TextLayout& help = text.cached("WASD/QEZX MOVE  F5 SALVA  F9 CARREGA  F3 DESEMPENHO", 1.5f);
+            text.add(help, (viewW - help.width) * 0.5f, viewH - help.height - 6.0f, TextColor::white());
+
+            if (state.gameOver || state.won) {
+                const TextLayout& big = state.gameOver ? text.cached("GAME OVER", 6.0f) : text.cached("VITORIA!", 6.0f);
+                float bx = (viewW - big.width) * 0.5f, by = (viewH - big.height) * 0.5f;
+                text.rect(bx - 16.0f, by - 12.0f, big.width + 32.0f, big.height + 20.0f, TextColor::shade());
+                text.add(big, bx, by, state.gameOver ? TextColor::red() : TextColor::green());
+            } else if (currentTime < hudMessageUntil) {
+                const TextLayout& msg = text.cached(hudMessage, 3.0f);
+                text.add(msg, (viewW - msg.width) * 0.5f, 60.0f, TextColor::yellow());
+            }
+
+            perf.frame(deltaTime);
+            if (showPerf) {
+                const float px = viewW - PerfOverlay::HISTORY * 2.0f - 18.0f;
+                perf.draw(text, px, 110.0f, lastDrawCalls, (long long)lastFrameAllocs);
+                // latência da entrada até o swap (últimas InputLatency::SAMPLES ações)
+                char line[64];
+                std::snprintf(line, sizeof(line), "ENTRADA P50 %.1f P99 %.1f MS",
+                              g_inputLatency.percentile(0.50), g_inputLatency.percentile(0.99));
+                text.rect(px, 244.0f, PerfOverlay::HISTORY * 2.0f + 8.0f, 20.0f, TextColor::shade());
+                text.text(px + 4, 248.0f, line, 1.5f, TextColor::white());
+                std::snprintf(line, sizeof(line), "CENA %dX%d %d%% GPU %.1f MS", resolution.width(),
+                              resolution.height(), (int)std::lround(resolution.scale() * 100.0f),
+                              resolution.gpuMs());
+                text.rect(px, 266.0f, PerfOverlay::HISTORY * 2.0f + 8.0f, 20.0f, TextColor::shade());
+                text.text(px + 4, 270.0f, line, 1.5f, TextColor::white());
+            }
+            drawCalls += text.flush();
+        }
+        noAlloc.end();
+
+        // leitura do frame pronto (com HUD) para um PBO; os pixels chegam frames depois
+        if (capture.active()) {
+            capture.capture(fbW, fbH);
+            if (captureFrames && capture.captured() >= captureFrames) glfwSetWindowShouldClose(win, true);
+        }
+
+        frameUniforms.endFrame();
+        submitPhase.stop();
         glfwSwapBuffers(win);
+        g_inputLatency.presented(glfwGetTime());
+        renderTargets.endFrame();
+        gl::collectGarbage();
+        if (profile) profiler.endFrame(std::cout);
     }
 
+    if (saveThread.joinable()) saveThread.join();
+    Logger::instance().flush();
+    if (capture.active()) {
+        capture.finish();
+        std::printf("Captura: %llu frames gravados em %s (%llu erros); %llu esperas pela GPU, %llu pelo disco\n",
+                    (unsigned long long)capture.written(), captureDest.c_str(),
+                    (unsigned long long)capture.errors(), (unsigned long long)capture.gpuStalls(),
+                    (unsigned long long)capture.diskStalls());
+        if (captureFormat == FrameCapture::Format::Raw)
+            std::printf("Video bruto: rgb24 %dx%d (ffmpeg -f rawvideo -pixel_format rgb24 -video_size %dx%d "
+                        "-framerate 60 -i %s saida.mp4)\n",
+                        capture.rawWidth(), capture.rawHeight(), capture.rawWidth(), capture.rawHeight(),
+                        captureDest.c_str());
+    }
+    if (profile) {
+        std::cout << "Bloco Frame: " << frameUniforms.stalls() << " esperas pela GPU" << std::endl;
+        std::cout << "Arena do frame: pico " << frameArena.peak() / 1024 << " KB de " << frameArena.capacity() / 1024
+                  << " KB, " << frameArena.growths() << " blocos extras; " << alloc_stats::violations()
+                  << " alocacoes em trechos sem alocacao" << std::endl;
+        std::printf("Entrada ate o swap: %llu acoes, p50 %.2f ms, p99 %.2f ms (ultimas %zu); %llu eventos descartados\n",
+                    (unsigned long long)g_inputLatency.totalSamples(), g_inputLatency.percentile(0.50),
+                    g_inputLatency.percentile(0.99), g_inputLatency.count(), (unsigned long long)g_input.dropped());
+        std::printf("Resolucao da cena: escala final %.2f, %lu mudancas, GPU %.2f ms por frame\n",
+                    resolution.scale(), resolution.changes(), resolution.gpuMs());
+        renderTargets.report(std::cout);
+    }
+    resolution.shutdown(renderTargets);
+    renderTargets.clear();
+    frameUniforms.shutdown();
+    gl::reportLiveObjects(std::cout);
+    gl::shutdown();
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
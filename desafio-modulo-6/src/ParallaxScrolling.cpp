@@ -9,10 +9,17 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "transform2d.h"
+#include "ecs.h"
+#include "job_system.h"
+#include "frame_profiler.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 //-----------------------------------------------------------------------------
 
@@ -77,14 +84,15 @@ layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec2 aUV;
 
 uniform mat4 projection;
-uniform mat4 model;
+uniform vec3 model[2];   // linhas da afim 2x3
 uniform vec2 texScale;
 uniform vec2 texOffset;
 
 out vec2 UV;
 void main(){
     UV = aUV * texScale + texOffset;
-    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+    vec3 p = vec3(aPos, 1.0);
+    gl_Position = projection * vec4(dot(model[0], p), dot(model[1], p), 0.0, 1.0);
 }
 )glsl";
 
@@ -140,98 +148,112 @@ static GLuint createShaderProgram() {
     return prog;
 }
 
-struct Sprite {
-    GLuint   tex;
-    glm::vec2 pos;
-    glm::vec2 scale;
-    float     rot;
-
-    Sprite(GLuint _tex = 0) : tex(_tex), pos(0,0), scale(1,1), rot(0) {}
-
-    // Configura a transformação e desenha o quad
-    void Draw(GLuint prog) {
-        // Monta a matriz modelo = T * R * S
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(pos, 0.0f));
-        model = glm::rotate(model, glm::radians(rot), glm::vec3(0, 0, 1));
-        model = glm::scale(model, glm::vec3(scale, 1.0f));
-
-        // Passa para o shader
-        glUniformMatrix4fv(glGetUniformLocation(prog, "model"),
-                           1, GL_FALSE, glm::value_ptr(model));
-
-        // Para um atlas 1×1 (no caso não usamos sub-UV), texScale=1, texOffset=0
-        glUniform2f(glGetUniformLocation(prog, "texScale"), 1.0f, 1.0f);
-        glUniform2f(glGetUniformLocation(prog, "texOffset"), 0.0f, 0.0f);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glBindVertexArray(quadVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
-    }
+// ===========================================
+// Componentes da cena (ECS, include/ecs.h)
+// ===========================================
+struct Transform {
+    float x, y;   // centro em pixels
+    float w, h;   // tamanho em pixels
 };
 
-struct SpriteAnim {
-    GLuint   tex;
-    int      nRows, nCols;
-    float    frameDur, acc = 0.0f;
-    int      currentFrame = 0;
-    int      currentRow   = 0;
-    glm::vec2 pos;
-    glm::vec2 scale;
-    float     rot;
-
-    SpriteAnim(GLuint _tex, int rows, int cols, float dur)
-      : tex(_tex), nRows(rows), nCols(cols), frameDur(dur),
-        pos(0,0), scale(1,1), rot(0) {}
-
-    void setAnimation(int row) {
-        if (row < 0 || row >= nRows) return;
-        if (row != currentRow) {
-            currentRow   = row;
-            currentFrame = 0;
-            acc = 0.0f;
-        }
+struct Model {
+    Affine2D m;         // afim 2x3 enviada ao shader
+    bool     visible;   // algum pedaço do quad cai dentro da janela
+};
+
+struct Textured {
+    GLuint tex;
+};
+
+struct ParallaxLayer {
+    float factor;   // fração do deslocamento da câmera
+    float offset;   // 0 para o primeiro tile, SCR_W para o segundo (à direita)
+};
+
+// Animação por spritesheet (uma linha por animação, frames nas colunas)
+struct AnimClip {
+    GLuint tex;
+    int    nRows, nCols;
+    float  frameDur;
+};
+
+struct Animator {
+    int   clip;          // índice em animClips
+    int   frame;
+    int   row;
+    float acc;
+};
+
+std::vector<AnimClip> animClips;
+
+// Troca de animação reinicia a contagem de frames
+void setClip(Animator& a, int clip) {
+    if (a.clip != clip) {
+        a.clip  = clip;
+        a.frame = 0;
+        a.acc   = 0.0f;
     }
+}
+
+// ===========================================
+// Sistemas
+// ===========================================
+void scrollSystem(ecs::World& world, float cameraX) {
+    world.forEach<ParallaxLayer, Transform>([&](const ParallaxLayer& l, Transform& t) {
+        float desloc = fmodf(cameraX * l.factor, float(SCR_W));
+        if (desloc < 0.0f) desloc += float(SCR_W);
+        t.x = float(SCR_W)*0.5f - desloc + l.offset;
+    });
+}
 
-    void Update(float dt) {
-        acc += dt;
-        if (acc >= frameDur) {
-            currentFrame = (currentFrame + 1) % nCols;
-            acc -= frameDur;
+void animationSystem(ecs::World& world, float dt) {
+    world.forEach<Animator>([&](Animator& a) {
+        const AnimClip& c = animClips[a.clip];
+        a.acc += dt;
+        if (a.acc >= c.frameDur) {
+            a.frame = (a.frame + 1) % c.nCols;
+            a.acc -= c.frameDur;
         }
-    }
+    });
+}
 
-    void Draw(GLuint prog) {
-        // model = T * R * S
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(pos, 0.0f));
-        model = glm::rotate(model, glm::radians(rot), glm::vec3(0, 0, 1));
-        model = glm::scale(model, glm::vec3(scale, 1.0f));
-        glUniformMatrix4fv(glGetUniformLocation(prog, "model"),
-                           1, GL_FALSE, glm::value_ptr(model));
-
-        // Cálculo de sub-UV:
-        float cellW = 1.0f / float(nCols);
-        float cellH = 1.0f / float(nRows);
-        glm::vec2 texScale(cellW, cellH);
-        glm::vec2 texOffset(currentFrame * cellW,
-                            (nRows - 1 - currentRow) * cellH);
-
-        glUniform2fv(glGetUniformLocation(prog, "texScale"), 1, &texScale.x);
-        glUniform2fv(glGetUniformLocation(prog, "texOffset"), 1, &texOffset.x);
-
-        // Desenha
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glBindVertexArray(quadVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
+// Transform -> afim 2x3, em lote (computeAffines) um bloco (chunk) do ECS por vez;
+// também recorta contra a janela (a cópia da camada que saiu da tela não é desenhada)
+void modelSystem(ecs::World& world) {
+    Transform2DBatch      batch;
+    std::vector<Affine2D> out;
+    world.forEachChunk<Transform, Model>([&](size_t n, ecs::Entity*, Transform* ts, Model* ms) {
+        batch.clear();
+        for (size_t i = 0; i < n; ++i) batch.add(ts[i].x, ts[i].y, ts[i].w, ts[i].h);
+        computeAffines(batch, out);
+        for (size_t i = 0; i < n; ++i) {
+            const Transform& t = ts[i];
+            ms[i].m = out[i];
+            ms[i].visible = t.x + t.w * 0.5f > 0.0f && t.x - t.w * 0.5f < float(SCR_W) &&
+                            t.y + t.h * 0.5f > 0.0f && t.y - t.h * 0.5f < float(SCR_H);
+        }
+    });
+}
+
+void drawQuad(GLint locModel, GLint locTexScale, GLint locTexOffset, GLuint tex,
+              const Affine2D& model, float sx, float sy, float ox, float oy) {
+    glUniform3fv(locModel, 2, model.rows());
+    glUniform2f(locTexScale, sx, sy);
+    glUniform2f(locTexOffset, ox, oy);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
+
+int main(int argc, char** argv) {
+    // --profile imprime tempos das fases e utilização dos núcleos a cada 2 s
+    bool profile = false;
+    for (int a = 1; a < argc; ++a) {
+        if (std::string(argv[a]) == "--profile") profile = true;
     }
-};
 
-int main() {
     // 1) Inicialização GLFW + GLAD
     if (!glfwInit()) {
         std::cerr << "Falha ao inicializar GLFW." << std::endl;
@@ -298,37 +320,37 @@ int main() {
     }
 
     //-----------------------------------------------------------------------------  
-    // 3) Carrega cada camada de fundo como Sprite(1x1)
-    Sprite layer_sky     ( loadTexture("resources/background_layers/sky.png") );
-    Sprite layer_clouds1 ( loadTexture("resources/background_layers/clouds_1.png") );
-    Sprite layer_clouds2 ( loadTexture("resources/background_layers/clouds_2.png") );
-    Sprite layer_ground1 ( loadTexture("resources/background_layers/ground_1.png") );
-    Sprite layer_ground2 ( loadTexture("resources/background_layers/ground_2.png") );
-    Sprite layer_ground3 ( loadTexture("resources/background_layers/ground_3.png") );
-    Sprite layer_rocks   ( loadTexture("resources/background_layers/rocks.png") );
-    Sprite layer_plant   ( loadTexture("resources/background_layers/plant.png") );
-
-    // Faz com que cada camada cubra exatamente a janela (800×600)
-    layer_sky.pos   = { float(SCR_W)/2.0f, float(SCR_H)/2.0f };
-    layer_sky.scale = { float(SCR_W), float(SCR_H) };
-
-    layer_clouds1.pos = layer_sky.pos;    layer_clouds1.scale = layer_sky.scale;
-    layer_clouds2.pos = layer_sky.pos;    layer_clouds2.scale = layer_sky.scale;
-    layer_ground1.pos = layer_sky.pos;    layer_ground1.scale = layer_sky.scale;
-    layer_ground2.pos = layer_sky.pos;    layer_ground2.scale = layer_sky.scale;
-    layer_ground3.pos = layer_sky.pos;    layer_ground3.scale = layer_sky.scale;
-    layer_rocks.pos   = layer_sky.pos;    layer_rocks.scale   = layer_sky.scale;
-    layer_plant.pos   = layer_sky.pos;    layer_plant.scale   = layer_sky.scale;
-
-    SpriteAnim playerIdle ( loadTexture("resources/Gangsters/Idle.png"), 1, 7,  0.12f );
-    SpriteAnim playerWalk ( loadTexture("resources/Gangsters/Walk.png"), 1, 10, 0.10f );
-
-    playerIdle.pos   = { float(SCR_W)/2.0f, float(SCR_H)/2.0f };
-    playerIdle.scale = { 64.0f, 64.0f };   // 64×64 px no mundo
-    playerWalk.pos   = playerIdle.pos;
-    playerWalk.scale = playerIdle.scale;
-
-    SpriteAnim* player = &playerIdle;
+    // 3) Cena no ECS: cada camada de fundo (do fundo para a frente, com seu fator de
+    //    parallax) vira duas entidades lado a lado cobrindo a janela 800×600
+    ecs::World world;
+    const char* layerFiles[] = {
+        "resources/background_layers/sky.png",
+        "resources/background_layers/clouds_1.png",
+        "resources/background_layers/clouds_2.png",
+        "resources/background_layers/ground_1.png",
+        "resources/background_layers/ground_2.png",
+        "resources/background_layers/ground_3.png",
+        "resources/background_layers/rocks.png",
+        "resources/background_layers/plant.png",
+    };
+    const float layerFactor[] = { 0.10f, 0.20f, 0.30f, 0.50f, 0.70f, 0.90f, 1.10f, 1.30f };
+    for (int i = 0; i < 8; ++i) {
+        GLuint tex = loadTexture(layerFiles[i]);
+        for (int copy = 0; copy < 2; ++copy) {
+            world.create(Transform{ float(SCR_W)/2.0f, float(SCR_H)/2.0f, float(SCR_W), float(SCR_H) },
+                         Model{}, Textured{ tex }, ParallaxLayer{ layerFactor[i], copy * float(SCR_W) });
+        }
+    }
+
+    // 4) Personagem: 64×64 px no centro da tela, com as animações parado/andando
+    const int CLIP_IDLE = 0, CLIP_WALK = 1;
+    animClips.push_back({ loadTexture("resources/Gangsters/Idle.png"), 1, 7,  0.12f });
+    animClips.push_back({ loadTexture("resources/Gangsters/Walk.png"), 1, 10, 0.10f });
+    ecs::Entity player = world.create(Transform{ float(SCR_W)/2.0f, float(SCR_H)/2.0f, 64.0f, 64.0f },
+                                      Model{}, Animator{ CLIP_IDLE, 0, 0, 0.0f });
+
+    GLint locTexScale  = glGetUniformLocation(shader, "texScale");
+    GLint locTexOffset = glGetUniformLocation(shader, "texOffset");
 
     //-----------------------------------------------------------------------------  
     // 5) Variável global de “camera X” (offset do mundo) para o parallax
@@ -341,12 +363,17 @@ int main() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // Sistemas rodam como tarefas; a GL fica nesta thread
+    JobSystem jobs;
+    FrameProfiler profiler(&jobs);
+
     // Temporizador para animações
     float lastTime = static_cast<float>(glfwGetTime());
 
     //-----------------------------------------------------------------------------  
     // 6) Loop principal
     while (!glfwWindowShouldClose(window)) {
+        profiler.beginFrame();
         // ——> 6.1) Processa eventos do GLFW <——
         glfwPollEvents();  
         // Sem este glfwPollEvents(), a janela não chega a “aparecer” porque o
@@ -368,26 +395,37 @@ int main() {
         bool keyDown  = glfwGetKey(window, GLFW_KEY_DOWN)  == GLFW_PRESS
                       || glfwGetKey(window, GLFW_KEY_S)     == GLFW_PRESS;
 
+        Animator& anim = world.get<Animator>(player);
         if (keyLeft) {
             cameraX -= MOVE_SPEED * dt;
-            player = &playerWalk;
+            setClip(anim, CLIP_WALK);
         }
         else if (keyRight) {
             cameraX += MOVE_SPEED * dt;
-            player = &playerWalk;
+            setClip(anim, CLIP_WALK);
         }
         else if (keyUp || keyDown) {
-            player = &playerWalk;
+            setClip(anim, CLIP_WALK);
             // não alteramos cameraX verticalmente, afinal nosso parallax é apenas horizontal.
         }
         else {
-            player = &playerIdle;
+            setClip(anim, CLIP_IDLE);
         }
 
-        player->Update(dt);
+        // Sistemas: rolagem das camadas e animação mexem em componentes diferentes e
+        // rodam juntas; matrizes de modelo + recorte dependem da rolagem
+        {
+            FrameProfiler::ScopedPhase phase(profiler, "preparo");
+            JobSystem::Task scroll  = jobs.schedule([&] { scrollSystem(world, cameraX); });
+            JobSystem::Task animate = jobs.schedule([&] { animationSystem(world, dt); });
+            JobSystem::Task models  = jobs.schedule([&] { modelSystem(world); }, { scroll });
+            jobs.wait(animate);
+            jobs.wait(models);
+        }
 
         //-----------------------------------------------------------------------------  
         // 6.2) Limpa a tela
+        FrameProfiler::ScopedPhase submitPhase(profiler, "envio GL");
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -395,152 +433,20 @@ int main() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         glUniform1i(locOutline, 0);
 
-        // === 1) Layer “sky” (fator = 0.10f) ===
-        {
-            float fator   = 0.10f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;   // centro do primeiro tile
-            float x2 = x1 + float(SCR_W);            // segundo tile à direita
-
-            layer_sky.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_sky.pos = { x1, float(SCR_H)*0.5f };
-            layer_sky.Draw(shader);
-
-            layer_sky.pos = { x2, float(SCR_H)*0.5f };
-            layer_sky.Draw(shader);
-        }
-
-        // === 2) Layer “clouds_1” (fator = 0.20f) ===
-        {
-            float fator   = 0.20f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_clouds1.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_clouds1.pos = { x1, float(SCR_H)*0.5f };
-            layer_clouds1.Draw(shader);
-
-            layer_clouds1.pos = { x2, float(SCR_H)*0.5f };
-            layer_clouds1.Draw(shader);
-        }
-
-        // === 3) Layer “clouds_2” (fator = 0.30f) ===
-        {
-            float fator   = 0.30f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_clouds2.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_clouds2.pos = { x1, float(SCR_H)*0.5f };
-            layer_clouds2.Draw(shader);
-
-            layer_clouds2.pos = { x2, float(SCR_H)*0.5f };
-            layer_clouds2.Draw(shader);
-        }
-
-        // === 4) Layer “ground_1” (fator = 0.50f) ===
-        {
-            float fator   = 0.50f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_ground1.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_ground1.pos = { x1, float(SCR_H)*0.5f };
-            layer_ground1.Draw(shader);
-
-            layer_ground1.pos = { x2, float(SCR_H)*0.5f };
-            layer_ground1.Draw(shader);
-        }
-
-        // === 5) Layer “ground_2” (fator = 0.70f) ===
-        {
-            float fator   = 0.70f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_ground2.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_ground2.pos = { x1, float(SCR_H)*0.5f };
-            layer_ground2.Draw(shader);
-
-            layer_ground2.pos = { x2, float(SCR_H)*0.5f };
-            layer_ground2.Draw(shader);
-        }
-
-        // === 6) Layer “ground_3” (fator = 0.90f) ===
-        {
-            float fator   = 0.90f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_ground3.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_ground3.pos = { x1, float(SCR_H)*0.5f };
-            layer_ground3.Draw(shader);
-
-            layer_ground3.pos = { x2, float(SCR_H)*0.5f };
-            layer_ground3.Draw(shader);
-        }
-
-        // === 7) Layer “rocks” (fator = 1.10f) ===
-        {
-            float fator   = 1.10f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_rocks.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_rocks.pos = { x1, float(SCR_H)*0.5f };
-            layer_rocks.Draw(shader);
-
-            layer_rocks.pos = { x2, float(SCR_H)*0.5f };
-            layer_rocks.Draw(shader);
-        }
-
-        // === 8) Layer “plant” (fator = 1.30f) ===
-        {
-            float fator   = 1.30f;
-            float desloc  = fmodf(cameraX * fator, float(SCR_W));
-            if (desloc < 0.0f) desloc += float(SCR_W);
-
-            float x1 = float(SCR_W)*0.5f - desloc;
-            float x2 = x1 + float(SCR_W);
-
-            layer_plant.scale = { float(SCR_W), float(SCR_H) };
-
-            layer_plant.pos = { x1, float(SCR_H)*0.5f };
-            layer_plant.Draw(shader);
-
-            layer_plant.pos = { x2, float(SCR_H)*0.5f };
-            layer_plant.Draw(shader);
-        }
-
-        //---- Desenha o personagem (sempre no centro da tela) ----
-        player->Draw(shader);
+        // Camadas na ordem de criação (fundo -> frente), atlas 1×1
+        world.forEach<ParallaxLayer, Textured, Model>([&](const ParallaxLayer&, const Textured& t, const Model& m) {
+            if (!m.visible) return;
+            drawQuad(locModel, locTexScale, locTexOffset, t.tex, m.m, 1.0f, 1.0f, 0.0f, 0.0f);
+        });
+
+        //---- Desenha o personagem (sempre no centro da tela), com sub-UV do frame atual ----
+        world.forEach<Animator, Model>([&](const Animator& a, const Model& m) {
+            const AnimClip& c = animClips[a.clip];
+            float cellW = 1.0f / float(c.nCols);
+            float cellH = 1.0f / float(c.nRows);
+            drawQuad(locModel, locTexScale, locTexOffset, c.tex, m.m,
+                     cellW, cellH, a.frame * cellW, (c.nRows - 1 - a.row) * cellH);
+        });
 
         // PASS 2: Desenha o contorno (wireframe) do player
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -549,21 +455,17 @@ int main() {
         glLineWidth(2.0f);
 
         glBindVertexArray(outlineVAO);
-        {
-            glm::mat4 M = glm::translate(glm::mat4(1.0f),
-                                         glm::vec3(player->pos, 0.0f))
-                        * glm::scale   (glm::mat4(1.0f),
-                                       glm::vec3(player->scale, 1.0f));
-            glUniformMatrix4fv(locModel, 1, GL_FALSE, glm::value_ptr(M));
-            glDrawArrays(GL_LINE_LOOP, 0, 4);
-        }
+        glUniform3fv(locModel, 2, world.get<Model>(player).m.rows());
+        glDrawArrays(GL_LINE_LOOP, 0, 4);
 
         // Restaura fill e “desliga” outline
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         glUniform1i(locOutline, 0);
 
+        submitPhase.stop();
         //---- Troca buffers ----
         glfwSwapBuffers(window);
+        if (profile) profiler.endFrame(std::cout);
     }
 
     glfwTerminate();
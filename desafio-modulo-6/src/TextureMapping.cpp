@@ -9,6 +9,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "scene_graph.h"
+
 #include <cstdio>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -94,13 +96,14 @@ const char* vertexShaderSrc = R"(
 layout(location=0) in vec2 aPos;
 layout(location=1) in vec2 aUV;
 uniform mat4 projection;
-uniform mat4 model;
+uniform vec3 model[2];   // linhas da afim 2x3
 uniform vec2 texScale;
 uniform vec2 texOffset;
 out vec2 UV;
 void main(){
     UV = aUV * texScale + texOffset;
-    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+    vec3 p = vec3(aPos, 1.0);
+    gl_Position = projection * vec4(dot(model[0], p), dot(model[1], p), 0.0, 1.0);
 }
 )";
 const char* fragmentShaderSrc = R"(
@@ -150,16 +153,19 @@ GLuint createShaderProgram() {
     return prog;
 }
 
+// Hierarquia de transformações; as matrizes de mundo ficam em cache e só são
+// recalculadas quando algo se move (aqui nada se move: custo zero por frame)
+SceneGraph scene;
+
 struct Sprite {
     GLuint tex;
     int    frameCount;
     float  frameDur, acc = 0;
     int    current = 0;
-    glm::vec2 pos{0,0}, scale{1,1};
-    float rot = 0;
+    SceneGraph::NodeId node;
 
     Sprite(GLuint t, int fc, float fd)
-        : tex(t), frameCount(fc), frameDur(fd) {}
+        : tex(t), frameCount(fc), frameDur(fd), node(scene.add(SceneGraph::NONE, 0, 0)) {}
 
     void Update(float dt) {
         if (frameCount > 1) {
@@ -171,12 +177,8 @@ struct Sprite {
         }
     }
     void Draw(GLuint prog) {
-        // Model matrix
-        glm::mat4 m(1.0f);
-        m = glm::translate(m, glm::vec3(pos, 0.0f));
-        m = glm::rotate(m, glm::radians(rot), glm::vec3(0,0,1));
-        m = glm::scale(m, glm::vec3(scale,1.0f));
-        glUniformMatrix4fv(glGetUniformLocation(prog,"model"),1,GL_FALSE,glm::value_ptr(m));
+        // Model (afim 2x3 de mundo, em cache no grafo de cena)
+        glUniform3fv(glGetUniformLocation(prog,"model"),2,scene.world(node).rows());
         // UV sub-range
         glm::vec2 ts(1.0f/frameCount, 1.0f);
         glm::vec2 to(current * ts.x, 0.0f);
@@ -224,12 +226,9 @@ int main() {
     Sprite spr2 ( loadTexture("resources/sprite2.png"),     9, 0.1f );
 
     // Configura posições/escala
-    bg.pos   = { SCR_W/2.0f, SCR_H/2.0f };
-    bg.scale = { (float)SCR_W, (float)SCR_H };
-    spr1.pos   = { 200.0f,  50.0f };
-    spr1.scale = { 96.0f,   96.0f };
-    spr2.pos   = { 600.0f,  50.0f };
-    spr2.scale = { 96.0f,   96.0f };
+    scene.setTransform(bg.node,   SCR_W/2.0f, SCR_H/2.0f, (float)SCR_W, (float)SCR_H);
+    scene.setTransform(spr1.node, 200.0f,  50.0f,  96.0f,  96.0f);
+    scene.setTransform(spr2.node, 600.0f,  50.0f,  96.0f,  96.0f);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -244,6 +243,7 @@ int main() {
         // Atualiza animações
         spr1.Update(dt);
         spr2.Update(dt);
+        scene.update();
 
         glClearColor(0,0,0,1);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -259,25 +259,10 @@ int main() {
         glUniform1i(locOutline, 1);
         glUniform4f(locOutlineColor, 1,1,1,1);
 
-        {
-            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(bg.pos, 0.0f))
-                        * glm::scale   (glm::mat4(1.0f), glm::vec3(bg.scale,1.0f));
-            glUniformMatrix4fv(locModel,1,GL_FALSE, glm::value_ptr(m));
-            glBindVertexArray(outlineVAO);
-            glDrawArrays(GL_LINE_LOOP, 0, 4);
-        }
-
-        {
-            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(spr1.pos, 0.0f))
-                        * glm::scale   (glm::mat4(1.0f), glm::vec3(spr1.scale,1.0f));
-            glUniformMatrix4fv(locModel,1,GL_FALSE, glm::value_ptr(m));
-            glDrawArrays(GL_LINE_LOOP, 0, 4);
-        }
-
-        {
-            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(spr2.pos, 0.0f))
-                        * glm::scale   (glm::mat4(1.0f), glm::vec3(spr2.scale,1.0f));
-            glUniformMatrix4fv(locModel,1,GL_FALSE, glm::value_ptr(m));
+        // contornos usam a matriz de mundo dos próprios sprites
+        glBindVertexArray(outlineVAO);
+        for (const Sprite* spr : { &bg, &spr1, &spr2 }) {
+            glUniform3fv(locModel, 2, scene.world(spr->node).rows());
             glDrawArrays(GL_LINE_LOOP, 0, 4);
         }
 